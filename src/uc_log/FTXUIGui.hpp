@@ -1,9 +1,21 @@
 #pragma once
 
 #include "uc_log/FTXUI_Utils.hpp"
+#include "uc_log/ReorderQueueStats.hpp"
+#include "uc_log/SinkStats.hpp"
+#include "uc_log/detail/BootIndex.hpp"
+#include "uc_log/detail/CompiledFilter.hpp"
+#include "uc_log/detail/FilterRebuilder.hpp"
+#include "uc_log/detail/FilteredIndex.hpp"
 #include "uc_log/detail/LogEntry.hpp"
 #include "uc_log/detail/LogFormat.hpp"
+#include "uc_log/detail/LogStore.hpp"
+#include "uc_log/detail/LruCache.hpp"
+#include "uc_log/detail/MetricRegistry.hpp"
+#include "uc_log/detail/MetricSeries.hpp"
 #include "uc_log/detail/TcpPortStatus.hpp"
+#include "uc_log/detail/TimedEntry.hpp"
+#include "uc_log/detail/UcTimeIndex.hpp"
 #include "uc_log/metric_utils.hpp"
 #include "uc_log/theme.hpp"
 
@@ -62,6 +74,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <ftxui/component/component.hpp>
@@ -76,9 +90,11 @@
 #include <mutex>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 namespace glz {
 /// Registers every non-`std::byte` enum type with glaze using
@@ -159,19 +175,8 @@ namespace uc_log { namespace FTXUIGui {
         Gui& operator=(Gui&&) = delete;
 
     private:
-        enum class LineType : std::uint8_t {
-            SingleLine,   // Complete log on one line
-            First,        // First line of multiline log
-            Middle,       // Middle continuation line
-            Last          // Last line of multiline log
-        };
-
-        struct GuiLogEntry {
-            std::chrono::system_clock::time_point recv_time;
-            uc_log::detail::LogEntry              logEntry;
-            LineType                              lineType{LineType::SingleLine};
-            std::size_t                           multilineGroupId{0};
-        };
+        using LineType = uc_log::detail::LogLineType;
+        using LogLine  = uc_log::detail::LogLine;
 
         struct FilterState {
             std::set<uc_log::LogLevel> enabledLogLevels;
@@ -182,6 +187,22 @@ namespace uc_log { namespace FTXUIGui {
             bool operator==(FilterState const&) const = default;
         };
 
+        // filter the filtered view was last built with
+        struct IndexedFilter {
+            FilterState                  state;
+            bool                         ucTimeEnabled{false};
+            double                       minUcTimeSec{0.0};
+            double                       maxUcTimeSec{std::numeric_limits<double>::infinity()};
+            std::optional<std::uint64_t> boot;
+
+            bool operator==(IndexedFilter const&) const = default;
+        };
+
+        struct PendingFilter {
+            IndexedFilter                  filter;
+            uc_log::detail::CompiledFilter compiled;
+        };
+
         struct MessageEntry {
             enum class Level : std::uint8_t { Fatal, Error, Status, ToolError, ToolStatus };
 
@@ -238,40 +259,88 @@ namespace uc_log { namespace FTXUIGui {
             std::size_t                           peakLogsPerSecond{0};
             std::chrono::system_clock::time_point lastLogRateUpdate{
               std::chrono::system_clock::now()};
-            std::size_t                                     logsInCurrentSecond{0};
-            std::optional<uc_log::detail::LogEntry::UcTime> lastUcTime;
+            std::size_t                           logsInCurrentSecond{0};
 
             // Data statistics
             std::size_t maxBytesRead{0};
             std::size_t maxOverflowCount{0};
-        };
 
-        static constexpr auto NoFilter = [](GuiLogEntry const&) { return true; };
+            // Redraw statistics
+            std::size_t redrawRequests{0};
+            std::size_t wakeupsPosted{0};
+            std::size_t framesDrawn{0};
+            std::size_t framesSkipped{0};
+        };
 
         std::mutex mutex;
 
+        // Ingest only appends to `stagedEntries`, the gui thread swaps it out at the start of each
+        // frame, so add() never waits for a frame to be rendered. It only waits once the gui
+        // falls MaxStagedEntries behind, which leaves the gui sink's overflow policy in charge.
+        using StagedEntry = uc_log::detail::TimedEntry<uc_log::detail::LogEntry>;
+        std::mutex               stagingMutex;
+        std::condition_variable  stagingDrained;
+        std::vector<StagedEntry> stagedEntries;
+        std::vector<StagedEntry> splicedEntries;
+        bool                     splicing{false};   // run() is draining stagedEntries
+
         // Actions posted by button callbacks and drained after loop.RunOnce() releases gui.mutex.
         std::vector<std::function<void()>> pendingActions;
 
         std::atomic<bool> callJoin{false};
-        std::size_t       nextMultilineGroupId{0};
 
         std::size_t originalLogCount{0};           // Total original logs received
         std::size_t filteredOriginalLogCount{0};   // Original logs passing filter
+        std::size_t evictedLogCount{0};            // Original logs dropped by the store budget
 
         ftxui::ScreenInteractive* screenPointer = nullptr;
 
-        std::map<SourceLocation, std::size_t>           allSourceLocations;
-        std::vector<std::shared_ptr<GuiLogEntry const>> allLogEntries;
-        std::vector<std::shared_ptr<GuiLogEntry const>> filteredLogEntries;
-        std::map<MetricInfo, std::vector<MetricEntry>>  metricEntries;
+        // Changes only mark the frame dirty. The run loop posts a single wake-up once a frame is
+        // due and frames are drawn at most maxFps times per second, otherwise the last frame is
+        // shown again.
+        bool                                  redrawRequested{false};
+        bool                                  logsChanged{false};   // only new log lines
+        bool                                  inputReceived{false};
+        unsigned                              maxFps{GUI_Constants::DefaultMaxFps};
+        std::chrono::steady_clock::time_point lastFrameTime{};
+        ftxui::Element                        lastFrame;
+
+        // logs per call site are counted by id at ingest and folded into allSourceLocations
+        // only when a location view reads it, see sourceLocations()
+        std::map<SourceLocation, std::size_t>              allSourceLocations;
+        std::vector<std::size_t>                           callSiteLogCounts;   // by CallSiteId
+        std::vector<std::size_t>                           foldedCallSiteLogCounts;
+        std::vector<uc_log::detail::CallSiteId>            changedCallSites;
+        uc_log::detail::LogStore                           allLogEntries;
+        uc_log::detail::FilteredIndex                      filteredLogEntries;
+        uc_log::detail::UcTimeIndex                        ucTimeIndex;
+        uc_log::detail::BootIndex                          bootIndex;
+        std::map<MetricInfo, uc_log::detail::MetricSeries> metricEntries;
+        std::vector<uc_log::detail::MetricSeries*>         metricEntriesById;   // into the map
+
+        uc_log::detail::LogStoreLimits logStoreLimits{GUI_Constants::MaxLogEntries,
+                                                      GUI_Constants::MaxLogBytes};
+
+        uc_log::detail::MetricSeriesLimits metricSeriesLimits{GUI_Constants::MetricRawSamples,
+                                                              GUI_Constants::MetricTierBuckets,
+                                                              GUI_Constants::MetricTierFactor,
+                                                              GUI_Constants::MetricTiers};
 
         FTXUIGui::MetricPlotWidget metricPlotWidget;
 
         FilterState activeFilterState;
         FilterState editedFilterState;
 
-        std::function<bool(GuiLogEntry const&)> currentFilter = NoFilter;
+        uc_log::detail::CompiledFilter currentFilter;
+        IndexedFilter                  indexedFilter;
+
+        // large stores are filtered in the background, the current view stays until then
+        std::optional<PendingFilter>    pendingFilter;
+        std::uint64_t                   filterGeneration{};
+        uc_log::detail::FilterRebuilder filterRebuilder{[this]() {
+            std::lock_guard<std::mutex> const lock{mutex};
+            requestRedraw();
+        }};
 
         // UC time filter (seconds from target start = 0.0)
         bool             ucTimeFilterEnabled{false};
@@ -290,6 +359,12 @@ namespace uc_log { namespace FTXUIGui {
         std::string      ucTimeLiveWindowStr{"10"};
         ftxui::Component ucTimeLiveWindowInput;
 
+        // only show the lines of this boot, live mode follows the latest one
+        std::optional<std::uint64_t> bootFilter;
+        int                          selectedBootIndex{};
+
+        ScrollerState logScrollState;
+
         bool showSysTime{true};
         bool showFunctionName{false};
         bool showUcTime{true};
@@ -299,6 +374,12 @@ namespace uc_log { namespace FTXUIGui {
         bool showMetricString{false};
         bool showTypenameString{false};
 
+        // rendered log rows by sequence number, valid for the display options they were made with
+        using RenderCache
+          = uc_log::detail::LruCache<std::uint64_t, std::shared_ptr<ScrollableWithMetadata>>;
+        RenderCache  renderCache{GUI_Constants::RenderCacheSize};
+        std::uint8_t renderCacheOptions{};
+
         std::size_t lastMetricCount{0};
         bool        hasLastSelectedInfo{false};
         MetricInfo  lastSelectedInfo;
@@ -349,6 +430,9 @@ namespace uc_log { namespace FTXUIGui {
         std::function<std::size_t()>       tcpClientCountGetter;
         ftxui::Component                   tcpPortInputComponent;
 
+        std::function<ReorderQueueStats()>      queueStatsGetter;
+        std::function<std::vector<SinkStats>()> sinkStatsGetter;
+
         LogFileStatus                           logFileStatus{LogFileStatus::NotStarted};
         std::string                             logFileCurrentPath;
         std::string                             logDirInput;
@@ -383,7 +467,7 @@ namespace uc_log { namespace FTXUIGui {
                             bool               isError) {
             std::lock_guard<std::mutex> const lock{mutex};
             buildOutput.emplace_back(std::chrono::system_clock::now(), line, fromTool, isError);
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void addBuildOutputGui(std::string const& line,
@@ -401,16 +485,35 @@ namespace uc_log { namespace FTXUIGui {
             });
         }
 
-        static std::vector<std::string> splitIntoLines(std::string_view msg) {
+        static std::vector<std::string_view> splitIntoLines(std::string_view msg) {
             while(!msg.empty() && msg.back() == '\n') { msg.remove_suffix(1); }
 
-            if(msg.empty()) { return {""}; }
+            if(msg.empty()) { return {msg}; }
 
             auto splitView = msg | std::views::split('\n') | std::views::transform([](auto&& rng) {
-                                 return std::string(rng.begin(), rng.end());
+                                 return std::string_view{rng};
                              });
 
-            return std::vector<std::string>(splitView.begin(), splitView.end());
+            return std::vector<std::string_view>(splitView.begin(), splitView.end());
+        }
+
+        // number of lines splitIntoLines() returns
+        static std::size_t countLines(std::string_view msg) {
+            while(!msg.empty() && msg.back() == '\n') { msg.remove_suffix(1); }
+            return 1 + static_cast<std::size_t>(std::ranges::count(msg, '\n'));
+        }
+
+        // series of metric `id`, looking its MetricInfo up only the first time it is seen
+        uc_log::detail::MetricSeries& metricSeries(uc_log::detail::MetricId id) {
+            if(id >= metricEntriesById.size()) { metricEntriesById.resize(id + 1, nullptr); }
+            auto& series = metricEntriesById[id];
+            if(series == nullptr) {
+                series = &metricEntries
+                            .try_emplace(uc_log::detail::MetricRegistry::instance()[id],
+                                         metricSeriesLimits)
+                            .first->second;
+            }
+            return *series;
         }
 
         std::size_t calculatePrefixWidth() const {
@@ -715,8 +818,8 @@ namespace uc_log { namespace FTXUIGui {
             ++statistics.logsInCurrentSecond;
         }
 
-        std::string processLogMessage(std::string const& originalMsg) const {
-            std::string processedMsg = originalMsg;
+        std::string processLogMessage(std::string_view originalMsg) const {
+            std::string processedMsg{originalMsg};
             std::size_t pos          = 0;
 
             // Process @METRIC(...) markers
@@ -767,7 +870,14 @@ namespace uc_log { namespace FTXUIGui {
             return processedMsg;
         }
 
-        auto defaultRender(GuiLogEntry const& entry) {
+        std::uint8_t displayOptions() const {
+            return static_cast<std::uint8_t>(
+              (showSysTime ? 1U : 0U) | (showFunctionName ? 2U : 0U) | (showUcTime ? 4U : 0U)
+              | (showLocation ? 8U : 0U) | (showChannel ? 16U : 0U) | (showLogLevel ? 32U : 0U)
+              | (showMetricString ? 64U : 0U) | (showTypenameString ? 128U : 0U));
+        }
+
+        auto defaultRender(LogLine const& entry) {
             ftxui::Elements elements;
             elements.reserve(12);
 
@@ -784,18 +894,18 @@ namespace uc_log { namespace FTXUIGui {
                 }
 
                 if(showChannel) {
-                    elements.push_back(toElement(entry.logEntry.channel));
+                    elements.push_back(toElement(entry.channel));
                     elements.push_back(ftxui::text(" "));
                 }
 
                 if(showUcTime) {
-                    elements.push_back(ftxui::text(fmt::format("{}", entry.logEntry.ucTime))
+                    elements.push_back(ftxui::text(fmt::format("{}", entry.ucTime))
                                        | ftxui::color(Theme::Text::ucTime()));
                     elements.push_back(ftxui::text(" "));
                 }
 
                 if(showLogLevel) {
-                    elements.push_back(toElement(entry.logEntry.logLevel));
+                    elements.push_back(toElement(entry.logLevel()));
                     elements.push_back(ftxui::text("| ") | ftxui::color(Theme::Text::separator()));
                 }
             } else {
@@ -805,7 +915,7 @@ namespace uc_log { namespace FTXUIGui {
             }
 
             // Message is processed at render time so toggles apply to existing entries
-            elements.push_back(ansiColoredTextToFtxui(processLogMessage(entry.logEntry.logMsg)));
+            elements.push_back(ansiColoredTextToFtxui(processLogMessage(entry.logMsg())));
 
             auto scrollableContent = ftxui::hbox(elements) | ftxui::flex;
 
@@ -817,15 +927,14 @@ namespace uc_log { namespace FTXUIGui {
             if(showMetadata) {
                 ftxui::Elements metadata;
                 if(showFunctionName) {
-                    metadata.push_back(ftxui::text(entry.logEntry.functionName)
+                    metadata.push_back(ftxui::text(std::string{entry.functionName()})
                                        | ftxui::color(Theme::Text::functionName()));
                 }
 
                 if(showLocation) {
                     if(showFunctionName) { metadata.push_back(ftxui::text(" ")); }
                     metadata.push_back(
-                      ftxui::text(
-                        fmt::format("{}:{}", entry.logEntry.fileName, entry.logEntry.line))
+                      ftxui::text(fmt::format("{}:{}", entry.fileName(), entry.line()))
                       | ftxui::color(Theme::Text::metadata()));
                 }
                 // Add filler to push content to the right and ensure consistent width
@@ -840,6 +949,20 @@ namespace uc_log { namespace FTXUIGui {
                                                             std::move(metadataElement));
         }
 
+        // Rows only depend on the line and the display options, so scrolling and new lines only
+        // render the rows that were not on screen before. Toggling an option drops the cache.
+        std::shared_ptr<ScrollableWithMetadata> cachedRender(LogLine const& entry) {
+            auto const options = displayOptions();
+            if(options != renderCacheOptions) {
+                renderCache.clear();
+                renderCacheOptions = options;
+            }
+            if(auto const* rendered = renderCache.find(entry.seq)) { return *rendered; }
+            auto rendered = defaultRender(entry);
+            renderCache.insert(entry.seq, rendered);
+            return rendered;
+        }
+
         ftxui::Element renderMessage(MessageEntry const& entry) {
             ftxui::Elements elements;
             elements.reserve(3);
@@ -867,92 +990,397 @@ namespace uc_log { namespace FTXUIGui {
             return ftxui::hbox(elements);
         }
 
-        bool passesAllFilters(GuiLogEntry const& ep) const {
-            if(!currentFilter(ep)) { return false; }
-            if(ucTimeFilterEnabled) {
-                auto const s = std::chrono::duration<double>(ep.logEntry.ucTime.time).count();
-                if(s < minUcTimeSec || s > maxUcTimeSec) { return false; }
+        bool passesAllFilters(LogLine const& ep) const { return currentFilter.passes(ep); }
+
+        // sets where empty means everything
+        template<typename T>
+        static bool isWithin(std::set<T> const& narrow,
+                             std::set<T> const& wide) {
+            if(wide.empty()) { return true; }
+            return !narrow.empty() && std::ranges::includes(wide, narrow);
+        }
+
+        // conservative where includes and excludes interact, false only costs a full rebuild
+        static bool locationsWithin(FilterState const& narrow,
+                                    FilterState const& wide) {
+            if(wide.includedLocations.empty() && wide.excludedLocations.empty()) { return true; }
+            if(narrow.includedLocations == wide.includedLocations) {
+                if(narrow.excludedLocations == wide.excludedLocations) { return true; }
+                if(!narrow.excludedLocations.empty() && !wide.excludedLocations.empty()) {
+                    return std::ranges::includes(narrow.excludedLocations, wide.excludedLocations);
+                }
+            }
+            if(narrow.excludedLocations.empty() && wide.excludedLocations.empty()) {
+                return isWithin(narrow.includedLocations, wide.includedLocations);
+            }
+            return false;
+        }
+
+        // true if every line passing `narrow` also passes `wide`
+        static bool filterWithin(IndexedFilter const& narrow,
+                                 IndexedFilter const& wide) {
+            if(!isWithin(narrow.state.enabledLogLevels, wide.state.enabledLogLevels)
+               || !isWithin(narrow.state.enabledChannels, wide.state.enabledChannels)
+               || !locationsWithin(narrow.state, wide.state))
+            {
+                return false;
             }
+            if(wide.boot.has_value() && narrow.boot != wide.boot) { return false; }
+            if(!wide.ucTimeEnabled) { return true; }
+            return narrow.ucTimeEnabled && narrow.minUcTimeSec >= wide.minUcTimeSec
+                && narrow.maxUcTimeSec <= wide.maxUcTimeSec;
+        }
 
-            return true;
+        IndexedFilter currentIndexedFilter() const {
+            return IndexedFilter{activeFilterState,
+                                 ucTimeFilterEnabled,
+                                 minUcTimeSec,
+                                 maxUcTimeSec,
+                                 bootFilter};
         }
 
-        void updateFilteredLogEntries() {
+        // lines of `boot`, all lines without one
+        std::pair<std::uint64_t, std::uint64_t>
+        bootSeqRange(std::optional<std::uint64_t> const& boot) const {
+            if(!boot.has_value()) { return {0, std::numeric_limits<std::uint64_t>::max()}; }
+            return bootIndex.seqRange(*boot);
+        }
+
+        // all lines of a log share the same filter result, so counting the first lines also
+        // works for the filtered view
+        void rebuildFilteredLogEntries() {
+            cancelFilterRebuild();
+            auto const filter   = currentIndexedFilter();
+            auto       compiled = createFilter(filter);
+            if(allLogEntries.size() >= GUI_Constants::ParallelFilterThreshold) {
+                filterRebuilder.start(++filterGeneration, allLogEntries.snapshot(), compiled);
+                pendingFilter = PendingFilter{filter, std::move(compiled)};
+                return;
+            }
+
+            indexedFilter = filter;
+            currentFilter = std::move(compiled);
             filteredLogEntries.clear();
-            std::set<std::size_t> uniqueGroupIds{};
-            std::ranges::copy_if(allLogEntries,
-                                 std::back_inserter(filteredLogEntries),
-                                 [&](auto const& ep) {
-                                     if(!passesAllFilters(*ep)) { return false; }
-                                     uniqueGroupIds.insert(ep->multilineGroupId);
-                                     return true;
-                                 });
-            filteredOriginalLogCount = uniqueGroupIds.size();
+            filteredOriginalLogCount = 0;
+
+            std::vector<std::uint8_t> matches;
+            allLogEntries.forEachChunk([&](uc_log::detail::LogStore::Columns const& columns) {
+                currentFilter.evaluate(columns, matches);
+                filteredLogEntries.append(columns.firstSeq, matches);
+                for(std::size_t i{}; i < columns.size(); ++i) {
+                    filteredOriginalLogCount
+                      += matches[i]
+                       & static_cast<std::uint8_t>(uc_log::detail::startsLog(columns.lineType[i]));
+                }
+            });
+        }
+
+        void cancelFilterRebuild() {
+            pendingFilter.reset();
+            filterRebuilder.cancel();
+        }
+
+        // Swaps in a finished background rebuild and catches up with the lines that were added
+        // and evicted while it ran.
+        void applyFilterRebuild() {
+            auto result = filterRebuilder.take();
+            if(!result || !pendingFilter || result->generation != filterGeneration) { return; }
+
+            auto&       index    = result->index;
+            auto        logCount = result->logCount;
+            auto const& snapshot = result->snapshot;
+            while(!index.empty()) {
+                auto const seq = index.seq(0, snapshot.beginSeq());
+                if(seq >= allLogEntries.beginSeq()) { break; }
+                if(uc_log::detail::startsLog(snapshot.lineType(seq))) { --logCount; }
+                index.pop_front();
+            }
+
+            indexedFilter = pendingFilter->filter;
+            currentFilter = std::move(pendingFilter->compiled);
+            pendingFilter.reset();
+            currentFilter.resolveCallSites();
+            for(auto seq = std::max(snapshot.endSeq(), allLogEntries.beginSeq());
+                seq != allLogEntries.endSeq();
+                ++seq)
+            {
+                auto const ep = allLogEntries.at(seq);
+                if(!passesAllFilters(ep)) { continue; }
+                index.push_back(seq);
+                if(ep.startsLog()) { ++logCount; }
+            }
+            filteredLogEntries       = std::move(index);
+            filteredOriginalLogCount = logCount;
+            updateFilteredLogEntries();
+        }
+
+        // Only the uC time window or the boot changed. Per segment of the time index both
+        // windows are ranges of lines, so the lines leaving the window are erased from the view
+        // and the ones entering it are inserted. Sliding the live window drops lines from the
+        // front.
+        void moveUcTimeWindow(IndexedFilter const& filter) {
+            auto const oldMin  = currentFilter.minTime();
+            auto const oldMax  = currentFilter.maxTime();
+            auto const oldSeqs = currentFilter.seqRange();
+            if(filter.ucTimeEnabled) {
+                currentFilter.setUcTimeRange(filter.minUcTimeSec, filter.maxUcTimeSec);
+            } else {
+                currentFilter.setUcTimeRange(-std::numeric_limits<double>::infinity(),
+                                             std::numeric_limits<double>::infinity());
+            }
+            auto const newSeqs = bootSeqRange(filter.boot);
+            currentFilter.setSeqRange(newSeqs.first, newSeqs.second);
+            indexedFilter = filter;
+
+            auto const base   = allLogEntries.beginSeq();
+            auto const timeAt = [this](std::uint64_t seq) {
+                return allLogEntries.ucTime(seq).time;
+            };
+            auto const onErase = [this](std::uint64_t seq) {
+                if(allLogEntries.at(seq).startsLog()) { --filteredOriginalLogCount; }
+            };
+            auto const add = [this](std::uint64_t seq) {
+                auto const ep = allLogEntries.at(seq);
+                if(!passesAllFilters(ep)) { return false; }
+                if(ep.startsLog()) { ++filteredOriginalLogCount; }
+                return true;
+            };
+            using uc_log::detail::UcTimeIndex;
+            auto const clip = [](UcTimeIndex::SeqRange                          range,
+                                 std::pair<std::uint64_t, std::uint64_t> const& seqs) {
+                auto const begin = std::max(range.begin, seqs.first);
+                auto const end   = std::min(range.end, seqs.second);
+                return UcTimeIndex::SeqRange{begin, std::max(begin, end)};
+            };
+            for(auto const& segment : ucTimeIndex.segments()) {
+                auto const before
+                  = clip(UcTimeIndex::range(segment, oldMin, oldMax, timeAt), oldSeqs);
+                auto const after = clip(
+                  UcTimeIndex::range(
+                    segment, currentFilter.minTime(), currentFilter.maxTime(), timeAt),
+                  newSeqs);
+                filteredLogEntries.erase(
+                  before.begin, std::min(after.begin, before.end), base, onErase);
+                filteredLogEntries.erase(
+                  std::max(after.end, before.begin), before.end, base, onErase);
+                filteredLogEntries.insert(
+                  after.begin, std::min(before.begin, after.end), base, add);
+                filteredLogEntries.insert(
+                  std::max(before.end, after.begin), after.end, base, add);
+            }
+        }
+
+        // A narrower filter only has to look at the lines shown so far, a wider one only at the
+        // lines hidden so far. Anything else, and widening a large store, rebuilds the view.
+        void updateFilteredLogEntries() {
+            auto const filter = currentIndexedFilter();
+            if(pendingFilter) {
+                // uC time and boot changes, e.g. by live mode, follow once the rebuild is in
+                if(pendingFilter->filter.state == filter.state) { return; }
+                cancelFilterRebuild();
+            }
+            if(filter.state == indexedFilter.state) {
+                moveUcTimeWindow(filter);
+                return;
+            }
+            bool const narrower = filterWithin(filter, indexedFilter);
+            bool const wider    = filterWithin(indexedFilter, filter);
+
+            if(narrower && wider) { return; }
+            if(!narrower
+               && (!wider || allLogEntries.size() >= GUI_Constants::ParallelFilterThreshold))
+            {
+                rebuildFilteredLogEntries();
+                return;
+            }
+            indexedFilter = filter;
+            currentFilter = createFilter(indexedFilter);
+            if(narrower) {
+                filteredOriginalLogCount = 0;
+                filteredLogEntries.retain(allLogEntries.beginSeq(), [this](std::uint64_t seq) {
+                    auto const ep = allLogEntries.at(seq);
+                    if(!passesAllFilters(ep)) { return false; }
+                    if(ep.startsLog()) { ++filteredOriginalLogCount; }
+                    return true;
+                });
+            } else {
+                filteredLogEntries.merge(allLogEntries.beginSeq(),
+                                         allLogEntries.endSeq(),
+                                         [this](std::uint64_t seq) {
+                                             auto const ep = allLogEntries.at(seq);
+                                             if(!passesAllFilters(ep)) { return false; }
+                                             if(ep.startsLog()) { ++filteredOriginalLogCount; }
+                                             return true;
+                                         });
+            }
+        }
+
+        void countCallSiteLog(uc_log::detail::CallSiteId id,
+                              bool                       added) {
+            if(id >= callSiteLogCounts.size()) {
+                callSiteLogCounts.resize(id + 1);
+                foldedCallSiteLogCounts.resize(id + 1);
+            }
+            auto& count = callSiteLogCounts[id];
+            if(!added && count == 0) { return; }
+            if(count == foldedCallSiteLogCounts[id]) { changedCallSites.push_back(id); }
+            count = added ? count + 1 : count - 1;
+        }
+
+        // Log counts per file and line, brings allSourceLocations up to date with the call sites
+        // counted since the last call.
+        std::map<SourceLocation, std::size_t>& sourceLocations() {
+            auto const& registry = uc_log::detail::CallSiteRegistry::instance();
+            for(auto const id : changedCallSites) {
+                auto&      folded = foldedCallSiteLogCounts[id];
+                auto const count  = callSiteLogCounts[id];
+                if(count == folded) { continue; }
+                auto const& site  = registry[id];
+                auto&       total = allSourceLocations[SourceLocation{site.fileName, site.line}];
+                total             = total + count - folded;
+                folded            = count;
+            }
+            changedCallSites.clear();
+            return allSourceLocations;
+        }
+
+        // Drops the oldest chunk and updates everything derived from it in place, the filtered
+        // view holds the evicted entries at its front in the same order.
+        void evictOldestLogs() {
+            auto const evicted = allLogEntries.frontChunkSize();
+            for(std::size_t i{}; i < evicted; ++i) {
+                auto const ep       = allLogEntries[i];
+                bool const filtered = filteredLogEntries.startsWith(allLogEntries.beginSeq() + i);
+                if(filtered) { filteredLogEntries.pop_front(); }
+                if(!ep.startsLog()) { continue; }
+
+                --originalLogCount;
+                ++evictedLogCount;
+                if(filtered) { --filteredOriginalLogCount; }
+                countCallSiteLog(ep.callSite, false);
+            }
+            bootIndex.dropBefore(allLogEntries.beginSeq() + evicted, [this](std::uint64_t seq) {
+                return allLogEntries.at(seq).startsLog();
+            });
+            allLogEntries.evictChunk();
+            ucTimeIndex.dropBefore(allLogEntries.beginSeq());
+        }
+
+        void enforceLogStoreLimits() {
+            while(allLogEntries.exceeds(logStoreLimits)
+                  && allLogEntries.frontChunkSize() < allLogEntries.size())
+            {
+                evictOldestLogs();
+            }
+        }
+
+        // Drops the lines before `seq`, the first line of a boot. The log count and the uC time
+        // range of what is left come from the boot index instead of another pass over the store.
+        void dropLogsBefore(std::uint64_t seq) {
+            auto const base = allLogEntries.beginSeq();
+            if(seq <= base) { return; }
+            // the filtered view holds the dropped lines at its front, no rebuild needed
+            filteredLogEntries.erase(base, seq, base, [this](std::uint64_t dropped) {
+                if(allLogEntries.at(dropped).startsLog()) { --filteredOriginalLogCount; }
+            });
+            bootIndex.dropBefore(seq, [this](std::uint64_t dropped) {
+                return allLogEntries.at(dropped).startsLog();
+            });
+            allLogEntries.popFront(static_cast<std::size_t>(seq - base));
+            ucTimeIndex.dropBefore(allLogEntries.beginSeq());
+            originalLogCount = 0;
+            ucTimeDataMin    = std::numeric_limits<double>::infinity();
+            ucTimeDataMax    = -std::numeric_limits<double>::infinity();
+            for(auto const& boot : bootIndex.boots()) {
+                originalLogCount += boot.logCount;
+                ucTimeDataMin
+                  = std::min(ucTimeDataMin, std::chrono::duration<double>(boot.firstTime).count());
+                ucTimeDataMax
+                  = std::max(ucTimeDataMax, std::chrono::duration<double>(boot.lastTime).count());
+            }
         }
 
         void clearBeforeLastBoot() {
-            auto it = allLogEntries.end();
-            for(auto cur = std::next(allLogEntries.begin()); cur != allLogEntries.end(); ++cur) {
-                auto prev = std::prev(cur);
-                if((*cur)->logEntry.ucTime.time < (*prev)->logEntry.ucTime.time) { it = cur; }
-            }
-            if(it == allLogEntries.end()) { return; }
-            allLogEntries.erase(allLogEntries.begin(), it);
-            std::set<std::size_t> uniqueGroupIds;
-            ucTimeDataMin = std::numeric_limits<double>::infinity();
-            ucTimeDataMax = -std::numeric_limits<double>::infinity();
-            for(auto const& ep : allLogEntries) {
-                uniqueGroupIds.insert(ep->multilineGroupId);
-                auto const ucSecs = std::chrono::duration<double>(ep->logEntry.ucTime.time).count();
-                ucTimeDataMin     = std::min(ucTimeDataMin, ucSecs);
-                ucTimeDataMax     = std::max(ucTimeDataMax, ucSecs);
+            if(bootIndex.boots().size() < 2) { return; }
+            dropLogsBefore(bootIndex.latest().beginSeq);
+        }
+
+        // Live mode shows the last seconds of the latest boot, an older boot's uC times would
+        // otherwise keep the window past everything the target logs after a reset.
+        void followLatestBoot() {
+            ucTimeFilterEnabled = true;
+            minUcTimeSec        = 0.0;
+            maxUcTimeSec        = std::numeric_limits<double>::infinity();
+            bootFilter.reset();
+            if(!bootIndex.empty()) {
+                auto const& boot     = bootIndex.latest();
+                auto const  lastSecs = std::chrono::duration<double>(boot.lastTime).count();
+                bootFilter           = boot.number;
+                minUcTimeSec         = std::max(0.0, lastSecs - ucTimeLiveWindowSecs);
             }
-            originalLogCount = uniqueGroupIds.size();
+            minUcTimeStr = fmt::format("{:.1f}", minUcTimeSec);
+            maxUcTimeStr.clear();
             updateFilteredLogEntries();
         }
 
-        auto createFilter(FilterState const& filterState) {
-            return [filterState](GuiLogEntry const& entry) {
-                if(!filterState.enabledLogLevels.empty()) {
-                    if(!filterState.enabledLogLevels.contains(entry.logEntry.logLevel)) {
-                        return false;
-                    }
-                }
-                if(!filterState.enabledChannels.empty()) {
-                    if(!filterState.enabledChannels.contains(entry.logEntry.channel.channel)) {
-                        return false;
-                    }
-                }
+        // The boot filtered on was open ended while it was the latest one, after a reset it ends
+        // where the new boot starts.
+        void closeBootFilters() {
+            if(indexedFilter.boot.has_value()) {
+                auto const seqs = bootSeqRange(indexedFilter.boot);
+                currentFilter.setSeqRange(seqs.first, seqs.second);
+            }
+            if(pendingFilter && pendingFilter->filter.boot.has_value()) {
+                auto const seqs = bootSeqRange(pendingFilter->filter.boot);
+                pendingFilter->compiled.setSeqRange(seqs.first, seqs.second);
+            }
+        }
 
-                SourceLocation const entryLocation{entry.logEntry.fileName, entry.logEntry.line};
-                SourceLocation const entryFile{entry.logEntry.fileName, 0};
+        uc_log::detail::CompiledFilter createFilter(IndexedFilter const& filter) const {
+            auto const& filterState = filter.state;
+            uc_log::detail::CompiledFilter::LocationRule locationRule;
+            if(!filterState.includedLocations.empty() || !filterState.excludedLocations.empty()) {
+                locationRule = [filterState](uc_log::detail::CallSiteInfo const& site) {
+                    SourceLocation const entryLocation{site.fileName, site.line};
+                    SourceLocation const entryFile{site.fileName, 0};
 
-                bool const hasExclusions = !filterState.excludedLocations.empty();
-                bool const hasInclusions = !filterState.includedLocations.empty();
+                    bool const hasExclusions = !filterState.excludedLocations.empty();
+                    bool const hasInclusions = !filterState.includedLocations.empty();
 
-                if(hasExclusions && filterState.excludedLocations.contains(entryLocation)) {
-                    return false;
-                }
+                    if(hasExclusions && filterState.excludedLocations.contains(entryLocation)) {
+                        return false;
+                    }
 
-                if(hasInclusions && filterState.includedLocations.contains(entryLocation)) {
-                    return true;
-                }
+                    if(hasInclusions && filterState.includedLocations.contains(entryLocation)) {
+                        return true;
+                    }
 
-                if(hasExclusions && filterState.excludedLocations.contains(entryFile)) {
-                    return false;
-                }
+                    if(hasExclusions && filterState.excludedLocations.contains(entryFile)) {
+                        return false;
+                    }
 
-                if(hasExclusions) { return true; }
-                if(hasInclusions) {
+                    if(hasExclusions) { return true; }
                     return filterState.includedLocations.contains(entryLocation)
                         || filterState.includedLocations.contains(entryFile);
-                }
-                return true;
-            };
+                };
+            }
+
+            uc_log::detail::CompiledFilter compiled{filterState.enabledLogLevels,
+                                                    filterState.enabledChannels,
+                                                    std::move(locationRule)};
+            if(filter.ucTimeEnabled) {
+                compiled.setUcTimeRange(filter.minUcTimeSec, filter.maxUcTimeSec);
+            }
+            auto const seqs = bootSeqRange(filter.boot);
+            compiled.setSeqRange(seqs.first, seqs.second);
+            return compiled;
         }
 
-        void exportFilteredLogs(std::string                                     dir,
-                                std::vector<std::shared_ptr<GuiLogEntry const>> entries) {
+        // runs as a pending action without the gui lock held, only the store access locks;
+        // lines evicted since the export was requested are skipped
+        void exportFilteredLogs(std::string                   dir,
+                                uc_log::detail::FilteredIndex entries,
+                                std::uint64_t                 base) {
             namespace lf       = uc_log::detail::logformat;
             namespace fs       = std::filesystem;
             auto const    path = fs::path{dir}
@@ -960,29 +1388,36 @@ namespace uc_log { namespace FTXUIGui {
                                              lf::toIso8601Utc(std::chrono::system_clock::now()));
             std::ofstream f{path};
             if(!f.is_open()) {
-                lastExportPath = path.string();
-                lastExportOk   = false;
+                {
+                    std::lock_guard<std::mutex> const lock{mutex};
+                    lastExportPath = path.string();
+                    lastExportOk   = false;
+                }
                 errorMessage(fmt::format("Export failed — cannot write: {:?}", path));
                 return;
             }
             lf::writeHeader(f);
-            for(auto const& ep : entries) { lf::writeEntry(f, ep->recv_time, ep->logEntry); }
-            lastExportPath  = path.string();
-            lastExportCount = entries.size();
-            lastExportOk    = true;
-            statusMessage(fmt::format("{} entries saved to {}", entries.size(), path.string()));
+            std::size_t written{};
+            {
+                std::lock_guard<std::mutex> const lock{mutex};
+                for(std::size_t pos{}; pos < entries.size(); ++pos) {
+                    auto const seq = entries.seq(pos, base);
+                    if(seq < allLogEntries.beginSeq()) { continue; }
+                    auto const line = allLogEntries.at(seq);
+                    lf::writeEntry(f, line.recv_time, line.toLogEntry());
+                    ++written;
+                }
+                lastExportPath  = path.string();
+                lastExportCount = written;
+                lastExportOk    = true;
+            }
+            statusMessage(fmt::format("{} entries saved to {}", written, path.string()));
         }
 
         void updateCurrentFilter() {
             if(activeFilterState == editedFilterState) { return; }
 
             activeFilterState = editedFilterState;
-
-            if(activeFilterState == FilterState{}) {
-                currentFilter = NoFilter;
-            } else {
-                currentFilter = createFilter(activeFilterState);
-            }
             updateFilteredLogEntries();
         }
 
@@ -1084,7 +1519,7 @@ namespace uc_log { namespace FTXUIGui {
         }
 
         void autoExcludeNoisyLocations() {
-            auto const result = computeOutliers(allSourceLocations,
+            auto const result = computeOutliers(sourceLocations(),
                                                 outlierMethod,
                                                 iqrMultiplier,
                                                 topNPercent,
@@ -1108,10 +1543,15 @@ namespace uc_log { namespace FTXUIGui {
 
         ftxui::Component getLogComponent() {
             return Scroller(
-              [this]() -> std::vector<std::shared_ptr<GuiLogEntry const>> const& {
-                  return filteredLogEntries;
+              [this]() {
+                  return std::views::iota(std::size_t{}, filteredLogEntries.size())
+                       | std::views::transform([this](std::size_t pos) {
+                             return allLogEntries.at(
+                               filteredLogEntries.seq(pos, allLogEntries.beginSeq()));
+                         });
               },
-              [this](auto const& entry) { return defaultRender(*entry); });
+              [this](LogLine const& entry) { return cachedRender(entry); },
+              &logScrollState);
         }
 
         ftxui::Component getStatusComponent() {
@@ -1180,8 +1620,8 @@ namespace uc_log { namespace FTXUIGui {
         }
 
         ftxui::Component getMetricPlotComponent() {
-            auto dataProvider
-              = [this](MetricInfo const& metric) -> std::optional<std::vector<MetricEntry> const*> {
+            auto dataProvider = [this](MetricInfo const& metric)
+              -> std::optional<uc_log::detail::MetricSeries const*> {
                 auto iter = metricEntries.find(metric);
                 if(iter != metricEntries.end() && !iter->second.empty()) { return &iter->second; }
                 return std::nullopt;
@@ -1251,6 +1691,7 @@ namespace uc_log { namespace FTXUIGui {
               "🗑️ Clear Metrics",
               [this]() {
                   metricEntries.clear();
+                  metricEntriesById.clear();
                   metricPlotWidget.setSelectedMetric(std::nullopt);
               },
               createButtonStyle(Theme::Button::Background::destructive(), Theme::Button::text()));
@@ -1311,7 +1752,8 @@ namespace uc_log { namespace FTXUIGui {
 
                                        auto const& currentValues = iter->second;
                                        double      latestValue
-                                         = currentValues.empty() ? 0.0 : currentValues.back().value;
+                                         = currentValues.empty() ? 0.0
+                                                                 : currentValues.latest().value;
 
                                        return ftxui::hbox(
                                                 {ftxui::text("📊 ")
@@ -1331,8 +1773,9 @@ namespace uc_log { namespace FTXUIGui {
                                                  ftxui::text(fmt::format(" = {:.3f}", latestValue))
                                                    | ftxui::color(Theme::Status::info())
                                                    | ftxui::bold,
-                                                 ftxui::text(fmt::format(" ({} values)",
-                                                                         currentValues.size()))
+                                                 ftxui::text(
+                                                   fmt::format(" ({} values)",
+                                                               currentValues.totalCount()))
                                                    | ftxui::color(Theme::Data::count())})
                                             | ftxui::flex;
                                    }) | ftxui::flex,
@@ -1550,16 +1993,17 @@ namespace uc_log { namespace FTXUIGui {
 
             ftxui::DropdownOption dropdownOptions;
             dropdownOptions.radiobox.entries
-              = std::make_unique<SourceLocationAdapter>(allSourceLocations);
+              = std::make_unique<SourceLocationAdapter>(
+                [this]() -> std::map<SourceLocation, std::size_t>& { return sourceLocations(); });
             dropdownOptions.radiobox.selected  = &selectedLocationIndex;
             dropdownOptions.radiobox.on_change = [this]() {
-                auto iter = std::next(allSourceLocations.begin(), selectedLocationIndex);
+                auto iter = std::next(sourceLocations().begin(), selectedLocationIndex);
                 selectedSourceLocation = iter->first;
             };
 
             dropdownOptions.radiobox.transform
               = [this](ftxui::EntryState const& state) -> ftxui::Element {
-                auto                 iter     = std::next(allSourceLocations.begin(), state.index);
+                auto                 iter     = std::next(sourceLocations().begin(), state.index);
                 SourceLocation const location = iter->first;
 
                 bool const isIncluded = editedFilterState.includedLocations.contains(location);
@@ -1587,10 +2031,11 @@ namespace uc_log { namespace FTXUIGui {
             dropdownComponents.push_back(ftxui::Dropdown(dropdownOptions));
 
             auto getSelectedLocation = [this]() -> SourceLocation {
-                if(!allSourceLocations.empty()
-                   && static_cast<std::size_t>(selectedLocationIndex) < allSourceLocations.size())
+                auto const& locations = sourceLocations();
+                if(!locations.empty()
+                   && static_cast<std::size_t>(selectedLocationIndex) < locations.size())
                 {
-                    return std::next(allSourceLocations.begin(), selectedLocationIndex)->first;
+                    return std::next(locations.begin(), selectedLocationIndex)->first;
                 }
                 return {};
             };
@@ -1766,11 +2211,12 @@ namespace uc_log { namespace FTXUIGui {
               " Export Filtered ",
               [this]() {
                   if(exportDirInput.empty()) { return; }
-                  auto snapshot = filteredLogEntries;
-                  pendingActions.push_back(
-                    [this, dir = exportDirInput, entries = std::move(snapshot)]() {
-                        exportFilteredLogs(std::move(dir), std::move(entries));
-                    });
+                  pendingActions.push_back([this,
+                                            dir     = exportDirInput,
+                                            entries = filteredLogEntries,
+                                            base    = allLogEntries.beginSeq()]() mutable {
+                      exportFilteredLogs(std::move(dir), std::move(entries), base);
+                  });
               },
               createButtonStyle(Theme::Button::Background::positive(), Theme::Button::text()));
 
@@ -1810,7 +2256,9 @@ namespace uc_log { namespace FTXUIGui {
                   maxUcTimeStr.clear();
                   minUcTimeSec = 0.0;
                   maxUcTimeSec = std::numeric_limits<double>::infinity();
+                  bootFilter.reset();
                   updateCurrentFilter();
+                  updateFilteredLogEntries();
               },
               createButtonStyle(Theme::Button::Background::destructive(), Theme::Button::text()));
 
@@ -1968,7 +2416,7 @@ namespace uc_log { namespace FTXUIGui {
 
             // Enhanced preview: delegates to computeOutliers — no duplication
             auto previewRenderer = ftxui::Renderer([this] {
-                auto const r = computeOutliers(allSourceLocations,
+                auto const r = computeOutliers(sourceLocations(),
                                                outlierMethod,
                                                iqrMultiplier,
                                                topNPercent,
@@ -1977,7 +2425,7 @@ namespace uc_log { namespace FTXUIGui {
                     return ftxui::text("  (need ≥ 3 known locations to preview)")
                          | ftxui::color(Theme::Status::inactive());
                 }
-                auto const n = allSourceLocations.size();
+                auto const n = sourceLocations().size();
                 auto const w = r.wouldExclude.size();
                 return ftxui::vbox(
                   {ftxui::text(fmt::format("  → {} of {} location{} would be excluded",
@@ -2116,12 +2564,7 @@ namespace uc_log { namespace FTXUIGui {
                       ucTimeLiveWindowSecs = secs;
                       ucTimeLiveWindowStr  = fmt::format("{:.0f}", secs);
                       ucTimeLiveMode       = true;
-                      ucTimeFilterEnabled  = true;
-                      minUcTimeSec         = std::max(0.0, ucTimeDataMax - secs);
-                      minUcTimeStr         = fmt::format("{:.1f}", minUcTimeSec);
-                      maxUcTimeSec         = std::numeric_limits<double>::infinity();
-                      maxUcTimeStr.clear();
-                      updateFilteredLogEntries();
+                      followLatestBoot();
                   },
                   createButtonStyle(Theme::Button::Background::settings(), Theme::Button::text()));
             };
@@ -2135,6 +2578,7 @@ namespace uc_log { namespace FTXUIGui {
                   minUcTimeStr.clear();
                   maxUcTimeSec = std::numeric_limits<double>::infinity();
                   maxUcTimeStr.clear();
+                  bootFilter.reset();
                   updateFilteredLogEntries();
               },
               createButtonStyle(Theme::Button::Background::destructive(), Theme::Button::text()));
@@ -2166,7 +2610,9 @@ namespace uc_log { namespace FTXUIGui {
                                    ? std::string{"--"}
                                    : fmt::format("{:.1f} – {:.1f} s", ucTimeDataMin, ucTimeDataMax);
                     auto liveStr = ucTimeLiveMode
-                                   ? fmt::format(" ⟳ live: last {:.0f} s", ucTimeLiveWindowSecs)
+                                   ? fmt::format(" ⟳ live: last {:.0f} s of boot #{}",
+                                                 ucTimeLiveWindowSecs,
+                                                 bootFilter.value_or(0))
                                    : std::string{};
                     return ftxui::vbox(
                              {ftxui::text("⏱ UC Time Filter") | ftxui::bold
@@ -2180,17 +2626,98 @@ namespace uc_log { namespace FTXUIGui {
                          | ftxui::border;
                 });
 
-            auto timeFilterSection = ucTimeSection;
+            // ── Boot section ─────────────────────────────────────────────────────
+            auto selectedBoot = [this]() -> uc_log::detail::BootIndex::Boot const* {
+                auto const& boots = bootIndex.boots();
+                if(boots.empty()) { return nullptr; }
+                auto const index
+                  = std::min(static_cast<std::size_t>(std::max(selectedBootIndex, 0)),
+                             boots.size() - 1);
+                return &boots[index];
+            };
+
+            ftxui::MenuOption bootMenuOption;
+            bootMenuOption.entries  = std::make_unique<BootListAdapter>(bootIndex);
+            bootMenuOption.selected = &selectedBootIndex;
+            auto bootMenu           = ftxui::Menu(bootMenuOption);
+
+            auto jumpToBootBtn = ftxui::Button(
+              " ⤓ Jump ",
+              [this, selectedBoot]() {
+                  auto const* boot = selectedBoot();
+                  if(boot == nullptr) { return; }
+                  logScrollState.jumpTarget
+                    = filteredLogEntries.position(boot->beginSeq, allLogEntries.beginSeq());
+                  selectedTab = 0;   // Logs
+              },
+              createButtonStyle(Theme::Button::Background::build(), Theme::Button::text()));
+
+            auto showBootBtn = ftxui::Button(
+              " 🔍 Only This Boot ",
+              [this, selectedBoot]() {
+                  auto const* boot = selectedBoot();
+                  if(boot == nullptr) { return; }
+                  ucTimeLiveMode = false;
+                  bootFilter     = boot->number;
+                  updateFilteredLogEntries();
+              },
+              createButtonStyle(Theme::Button::Background::settings(), Theme::Button::text()));
+
+            auto showAllBootsBtn = ftxui::Button(
+              " All Boots ",
+              [this]() {
+                  ucTimeLiveMode = false;
+                  bootFilter.reset();
+                  updateFilteredLogEntries();
+              },
+              createButtonStyle(Theme::Button::Background::settings(), Theme::Button::text()));
+
+            // the store is append only, so a boot can only be dropped with all older ones
+            auto dropBootsBtn = ftxui::Button(
+              " 🗑 Drop Up To Here ",
+              [this, selectedBoot]() {
+                  auto const* boot = selectedBoot();
+                  if(boot == nullptr || boot == &bootIndex.latest()) { return; }
+                  dropLogsBefore(boot->endSeq);
+              },
+              createButtonStyle(Theme::Button::Background::destructive(), Theme::Button::text()));
+
+            auto bootSection
+              = ftxui::Container::Vertical(
+                  {bootMenu | ftxui::vscroll_indicator | ftxui::frame
+                     | ftxui::size(ftxui::HEIGHT, ftxui::LESS_THAN, 6),
+                   ftxui::Container::Horizontal(
+                     {jumpToBootBtn, showBootBtn, showAllBootsBtn, dropBootsBtn})})
+              | ftxui::Renderer([this](ftxui::Element inner) {
+                    auto shownStr = bootFilter.has_value()
+                                    ? fmt::format(" Showing boot #{}", *bootFilter)
+                                    : std::string{" Showing all boots"};
+                    return ftxui::vbox(
+                             {ftxui::text("🔁 Boots") | ftxui::bold
+                                | ftxui::color(Theme::Header::primary()) | ftxui::center,
+                              ftxui::separator(),
+                              std::move(inner),
+                              ftxui::text(shownStr) | ftxui::color(Theme::Text::normal())})
+                         | ftxui::border;
+                });
+
+            auto timeFilterSection = ftxui::Container::Vertical({ucTimeSection, bootSection});
 
             auto clearLogButton = ftxui::Button(
               "❌ Clear All Log Entries",
               [this]() {
+                  bootIndex.dropBefore(allLogEntries.endSeq(),
+                                       [](std::uint64_t) { return false; });
                   allLogEntries.clear();
+                  ucTimeIndex.dropBefore(allLogEntries.beginSeq());
                   filteredLogEntries.clear();
                   originalLogCount         = 0;
                   filteredOriginalLogCount = 0;
                   ucTimeDataMin            = std::numeric_limits<double>::infinity();
                   ucTimeDataMax            = -std::numeric_limits<double>::infinity();
+                  // the boot filtered on is gone, live mode picks up the next one
+                  bootFilter.reset();
+                  updateFilteredLogEntries();
               },
               createButtonStyle(Theme::Button::Background::destructive(), Theme::Button::text()));
 
@@ -2497,7 +3024,8 @@ namespace uc_log { namespace FTXUIGui {
             });
         }
 
-        ftxui::Component getStatisticsComponent() {
+        template<typename Reader>
+        ftxui::Component getStatisticsComponent(Reader& rttReader) {
             auto resetButton = ftxui::Button(
               "🔄 Reset Statistics",
               [this]() { statistics = Statistics{}; },
@@ -2506,7 +3034,7 @@ namespace uc_log { namespace FTXUIGui {
             return ftxui::Container::Vertical(
               {resetButton,
                ftxui::Renderer([]() { return ftxui::separator(); }),
-               ftxui::Renderer([this]() {
+               ftxui::Renderer([this, &rttReader]() {
                    auto const now    = std::chrono::system_clock::now();
                    auto const uptime = std::chrono::duration_cast<std::chrono::seconds>(
                      now - statistics.sessionStartTime);
@@ -2609,10 +3137,169 @@ namespace uc_log { namespace FTXUIGui {
                                      static_cast<std::uint32_t>(statistics.maxOverflowCount)))
                                      | ftxui::color(statistics.maxOverflowCount > 0
                                                       ? Theme::Status::error()
-                                                      : Theme::Status::success())})});
+                                                      : Theme::Status::success())}),
+                      getPipelineStatistics(rttReader),
+                      getQueueStatistics(),
+                      getSinkStatistics(),
+                      getRedrawStatistics()});
                })});
         }
 
+        ftxui::Element getRedrawStatistics() const {
+            auto const number = [](std::size_t n) {
+                return FTXUIGui::formatNumber(static_cast<std::uint32_t>(n));
+            };
+
+            return ftxui::vbox(
+              {ftxui::text(""),
+               ftxui::text("🖥️ Redraw") | ftxui::bold | ftxui::color(Theme::Header::accent()),
+               ftxui::hbox({ftxui::text("  Requests: ") | ftxui::bold,
+                            ftxui::text(fmt::format("{} → {} wake-ups posted",
+                                                    number(statistics.redrawRequests),
+                                                    number(statistics.wakeupsPosted)))
+                              | ftxui::color(Theme::Status::info())}),
+               ftxui::hbox({ftxui::text("  Frames: ") | ftxui::bold,
+                            ftxui::text(fmt::format("{} drawn, {} skipped (max {} fps)",
+                                                    number(statistics.framesDrawn),
+                                                    number(statistics.framesSkipped),
+                                                    maxFps))
+                              | ftxui::color(Theme::Status::info())})});
+        }
+
+        ftxui::Element getQueueStatistics() const {
+            if(!queueStatsGetter) { return ftxui::emptyElement(); }
+            auto const queue = queueStatsGetter();
+            auto const ms    = [](std::chrono::microseconds d) {
+                return fmt::format("{:.1f}ms", std::chrono::duration<double, std::milli>(d).count());
+            };
+
+            return ftxui::vbox(
+              {ftxui::text(""),
+               ftxui::text("🔀 Reorder Queue") | ftxui::bold
+                 | ftxui::color(Theme::Header::accent()),
+               ftxui::hbox({ftxui::text("  Window: ") | ftxui::bold,
+                            ftxui::text(ms(queue.window)) | ftxui::color(Theme::Status::info())}),
+               ftxui::hbox({ftxui::text("  Channel Skew: ") | ftxui::bold,
+                            ftxui::text(fmt::format("{} over {} channel{}",
+                                                    ms(queue.skew),
+                                                    queue.sources,
+                                                    queue.sources == 1 ? "" : "s"))
+                              | ftxui::color(Theme::Status::info())}),
+               ftxui::hbox({ftxui::text("  Pending: ") | ftxui::bold,
+                            ftxui::text(FTXUIGui::formatNumber(
+                              static_cast<std::uint32_t>(queue.pending)))
+                              | ftxui::color(Theme::Status::info())}),
+               ftxui::hbox({ftxui::text("  Late Arrivals: ") | ftxui::bold,
+                            ftxui::text(FTXUIGui::formatNumber(
+                              static_cast<std::uint32_t>(queue.lateArrivals)))
+                              | ftxui::color(queue.lateArrivals > 0 ? Theme::Status::warning()
+                                                                    : Theme::Status::success())})});
+        }
+
+        ftxui::Element getSinkStatistics() const {
+            if(!sinkStatsGetter) { return ftxui::emptyElement(); }
+            auto const policyName = [](OverflowPolicy policy) {
+                switch(policy) {
+                case OverflowPolicy::Block:      return "lossless";
+                case OverflowPolicy::DropOldest: return "drop oldest";
+                case OverflowPolicy::Sample:     return "sample";
+                }
+                return "";
+            };
+
+            ftxui::Elements rows{
+              ftxui::text(""),
+              ftxui::text("📤 Sinks") | ftxui::bold | ftxui::color(Theme::Header::accent())};
+            for(auto const& sink : sinkStatsGetter()) {
+                rows.push_back(ftxui::hbox(
+                  {ftxui::text(fmt::format("  {}: ", sink.name)) | ftxui::bold,
+                   ftxui::text(fmt::format(
+                     "{} / {} queued (peak {}), {} delivered, {} ",
+                     FTXUIGui::formatNumber(static_cast<std::uint32_t>(sink.depth)),
+                     FTXUIGui::formatNumber(static_cast<std::uint32_t>(sink.capacity)),
+                     FTXUIGui::formatNumber(static_cast<std::uint32_t>(sink.maxDepth)),
+                     FTXUIGui::formatNumber(static_cast<std::uint32_t>(sink.delivered)),
+                     policyName(sink.policy)))
+                     | ftxui::color(Theme::Status::info()),
+                   ftxui::text(fmt::format(
+                     "{} dropped",
+                     FTXUIGui::formatNumber(static_cast<std::uint32_t>(sink.dropped))))
+                     | ftxui::color(sink.dropped > 0 ? Theme::Status::warning()
+                                                     : Theme::Status::success())}));
+            }
+            return ftxui::vbox(std::move(rows));
+        }
+
+        template<typename Reader>
+        static ftxui::Element getPipelineStatistics(Reader& rttReader) {
+            if constexpr(requires { rttReader.getPipelineStats(); }) {
+                auto const pipeline = rttReader.getPipelineStats();
+                auto const loadColor = [](double load) {
+                    return load > 0.8 ? Theme::Status::error()
+                         : load > 0.5 ? Theme::Status::warning()
+                                      : Theme::Status::success();
+                };
+
+                return ftxui::vbox(
+                  {ftxui::text(""),
+                   ftxui::text("⚙️ RTT Pipeline") | ftxui::bold
+                     | ftxui::color(Theme::Header::accent()),
+                   ftxui::hbox(
+                     {ftxui::text("  Poll Rate: ") | ftxui::bold,
+                      ftxui::text(fmt::format(
+                        "{}/s",
+                        FTXUIGui::formatBytes(
+                          static_cast<std::uint32_t>(pipeline.polledBytesPerSecond))))
+                        | ftxui::color(Theme::Status::info())}),
+                   ftxui::hbox({ftxui::text("  Poll Load: ") | ftxui::bold,
+                                ftxui::text(fmt::format("{:.1f}%", 100.0 * pipeline.pollLoad))
+                                  | ftxui::color(loadColor(pipeline.pollLoad))}),
+                   ftxui::hbox(
+                     {ftxui::text("  Poll Interval: ") | ftxui::bold,
+                      ftxui::text(fmt::format(
+                        "{:.2f}ms",
+                        std::chrono::duration<double, std::milli>(pipeline.pollInterval).count()))
+                        | ftxui::color(Theme::Status::info())}),
+                   ftxui::hbox({ftxui::text("  Overflow Rate: ") | ftxui::bold,
+                                ftxui::text(fmt::format("{:.2f}/s", pipeline.overflowsPerSecond))
+                                  | ftxui::color(pipeline.overflowsPerSecond > 0.0
+                                                   ? Theme::Status::error()
+                                                   : Theme::Status::success())}),
+                   ftxui::hbox(
+                     {ftxui::text("  Parse Rate: ") | ftxui::bold,
+                      ftxui::text(fmt::format("{:.0f} msgs/sec", pipeline.parsedMessagesPerSecond))
+                        | ftxui::color(Theme::Status::info())}),
+                   ftxui::hbox({ftxui::text("  Parse Load: ") | ftxui::bold,
+                                ftxui::text(fmt::format("{:.1f}% ({} thread{})",
+                                                        100.0 * pipeline.parseLoad,
+                                                        pipeline.parserThreads,
+                                                        pipeline.parserThreads == 1 ? "" : "s"))
+                                  | ftxui::color(loadColor(pipeline.parseLoad))}),
+                   ftxui::hbox(
+                     {ftxui::text("  Backlog: ") | ftxui::bold,
+                      ftxui::text(fmt::format(
+                        "{} behind parser",
+                        FTXUIGui::formatBytes(
+                          static_cast<std::uint32_t>(pipeline.polledBytes - pipeline.parsedBytes))))
+                        | ftxui::color(Theme::Status::info())}),
+                   ftxui::hbox(
+                     {ftxui::text("  Peak Ring Fill: ") | ftxui::bold,
+                      ftxui::text(fmt::format(
+                        "{} of {}",
+                        FTXUIGui::formatBytes(static_cast<std::uint32_t>(pipeline.maxRingFill)),
+                        FTXUIGui::formatBytes(static_cast<std::uint32_t>(pipeline.ringCapacity))))
+                        | ftxui::color(Theme::Status::info())}),
+                   ftxui::hbox({ftxui::text("  Ring Full Stalls: ") | ftxui::bold,
+                                ftxui::text(FTXUIGui::formatNumber(
+                                  static_cast<std::uint32_t>(pipeline.ringFullEvents)))
+                                  | ftxui::color(pipeline.ringFullEvents > 0
+                                                   ? Theme::Status::error()
+                                                   : Theme::Status::success())})});
+            } else {
+                return ftxui::emptyElement();
+            }
+        }
+
         template<typename Reader>
         ftxui::Component getDebuggerComponent(Reader& rttReader) {
             auto resetTargetBtn = ftxui::Button(
@@ -2841,7 +3528,8 @@ namespace uc_log { namespace FTXUIGui {
                                                              : Theme::Text::normal()),
                    ftxui::separator(),
 
-                   ftxui::text("🔍 " + std::string(filterActive ? "●" : "○"))
+                   ftxui::text("🔍 "
+                               + std::string(pendingFilter ? "◐" : filterActive ? "●" : "○"))
                      | ftxui::color(filterActive ? Theme::Status::success()
                                                  : Theme::Text::normal()),
                    ftxui::separator(),
@@ -2888,10 +3576,11 @@ namespace uc_log { namespace FTXUIGui {
                                              rttStatus.hostOverflowCount))))
                      | ftxui::color(rttStatus.hostOverflowCount == 0 ? Theme::Status::success()
                                                                      : Theme::Status::error()),
-                   totalCount >= GUI_Constants::MaxLogEntries ? ftxui::separator()
-                                                              : ftxui::text(""),
-                   totalCount >= GUI_Constants::MaxLogEntries
-                     ? ftxui::text("🚨 MEM") | ftxui::color(ftxui::Color::Red) | ftxui::bold
+                   evictedLogCount > 0 ? ftxui::separator() : ftxui::text(""),
+                   evictedLogCount > 0
+                     ? ftxui::text(
+                         fmt::format("🚨 MEM -{}", FTXUIGui::formatNumber(evictedLogCount)))
+                         | ftxui::color(ftxui::Color::Red) | ftxui::bold
                      : ftxui::text(""),
                    ftxui::separator(),
                    ftxui::text([this]() -> std::string {
@@ -2950,15 +3639,15 @@ namespace uc_log { namespace FTXUIGui {
         template<typename Reader>
         ftxui::Component getTabComponent(Reader& rttReader) {
             auto tabs = generateTabsComponent({
-              {    "📄 Logs",               getLogComponent()},
-              {   "🔨 Build",             getBuildComponent()},
-              {  "🔍 Filter",            getFilterComponent()},
-              {"🔧 Settings",          getSettingsComponent()},
-              {"🐛 Debugger", getDebuggerComponent(rttReader)},
-              { "📈 Metrics",            getMetricComponent()},
-              {  "💬 Status",            getStatusComponent()},
-              {   "📊 Stats",        getStatisticsComponent()},
-              {    "❓ Help",              getHelpComponent()}
+              {    "📄 Logs",                 getLogComponent()},
+              {   "🔨 Build",               getBuildComponent()},
+              {  "🔍 Filter",              getFilterComponent()},
+              {"🔧 Settings",            getSettingsComponent()},
+              {"🐛 Debugger",   getDebuggerComponent(rttReader)},
+              { "📈 Metrics",              getMetricComponent()},
+              {  "💬 Status",              getStatusComponent()},
+              {   "📊 Stats", getStatisticsComponent(rttReader)},
+              {    "❓ Help",                getHelpComponent()}
             });
 
             return ftxui::Container::Vertical({getStatusLineComponent(rttReader),
@@ -2967,63 +3656,133 @@ namespace uc_log { namespace FTXUIGui {
                  | ftxui::border;
         }
 
+        void requestRedraw() {
+            redrawRequested = true;
+            ++statistics.redrawRequests;
+        }
+
+        void requestLogRedraw() {
+            logsChanged = true;
+            ++statistics.redrawRequests;
+        }
+
+        // New lines only change what is shown right away when the log view follows them or the
+        // metrics are plotted, otherwise they wait for the idle redraw.
+        bool isFrameDue(std::chrono::steady_clock::time_point now) const {
+            if(lastFrame == nullptr || inputReceived) { return true; }
+            auto const sinceLastFrame = now - lastFrameTime;
+            if(sinceLastFrame >= GUI_Constants::IdleRedrawInterval) { return true; }
+            if(maxFps != 0 && sinceLastFrame < std::chrono::seconds{1} / maxFps) { return false; }
+            bool const logsShown = (selectedTab == 0 && logScrollState.following)   // Logs
+                                || selectedTab == 5;                                // Metrics
+            return redrawRequested || (logsChanged && logsShown);
+        }
+
+        ftxui::Element drawFrame(ftxui::Component const& component) {
+            auto const now = std::chrono::steady_clock::now();
+            if(!isFrameDue(now)) {
+                ++statistics.framesSkipped;
+                return lastFrame;
+            }
+            lastFrame       = component->Render();
+            lastFrameTime   = now;
+            redrawRequested = false;
+            logsChanged     = false;
+            inputReceived   = false;
+            ++statistics.framesDrawn;
+            return lastFrame;
+        }
+
     public:
         void add(std::chrono::system_clock::time_point recv_time,
                  uc_log::detail::LogEntry const&       entry) {
-            std::lock_guard<std::mutex> const lock{mutex};
+            std::unique_lock<std::mutex> lock{stagingMutex};
+            waitForStagingRoom(lock);
+            stagedEntries.push_back(StagedEntry{recv_time, entry});
+        }
+
+        void addBatch(
+          std::span<uc_log::detail::TimedEntry<uc_log::detail::LogEntry> const> entries) {
+            std::unique_lock<std::mutex> lock{stagingMutex};
+            waitForStagingRoom(lock);
+            stagedEntries.insert(stagedEntries.end(), entries.begin(), entries.end());
+        }
+
+    private:
+        void waitForStagingRoom(std::unique_lock<std::mutex>& lock) {
+            stagingDrained.wait(lock, [this]() {
+                return !splicing || stagedEntries.size() < GUI_Constants::MaxStagedEntries;
+            });
+        }
+
+        void setSplicing(bool active) {
+            {
+                std::lock_guard<std::mutex> const lock{stagingMutex};
+                splicing = active;
+            }
+            stagingDrained.notify_all();
+        }
 
+        // called at the start of each frame with the gui lock held
+        void spliceStagedEntries() {
+            {
+                std::lock_guard<std::mutex> const lock{stagingMutex};
+                splicedEntries.swap(stagedEntries);
+            }
+            stagingDrained.notify_all();
+            if(splicedEntries.empty()) { return; }
+            for(auto const& timed : splicedEntries) { addUnlocked(timed.recv_time, timed.entry); }
+            splicedEntries.clear();
+            requestLogRedraw();
+        }
+
+        void addUnlocked(std::chrono::system_clock::time_point recv_time,
+                         uc_log::detail::LogEntry const&       entry) {
             ++originalLogCount;
             updateLogRateStatistics();
 
-            // Detect target reset by checking if ucTime went backwards significantly
-            if(statistics.lastUcTime.has_value()) {
-                // If new time is less than last time, it's a backwards jump
-                if(entry.ucTime < statistics.lastUcTime.value()) {
-                    // Calculate how far backwards it went
-                    auto const timeDiff = statistics.lastUcTime.value().time - entry.ucTime.time;
-                    // If it went back by more than 1 second, consider it a reset
-                    if(timeDiff > std::chrono::seconds{1}) { ++statistics.detectedResetCount; }
-                }
-            }
-            statistics.lastUcTime = entry.ucTime;
+            std::size_t const newlineCount
+              = static_cast<std::size_t>(std::ranges::count(entry.logMsg(), '\n'));
 
             {
+                // the uC time going back by more than a second is a reset of the target
+                auto const lastTime = bootIndex.empty() ? std::chrono::nanoseconds::min()
+                                                        : bootIndex.latest().lastTime;
+                bool const reset    = bootIndex.push_back(
+                  allLogEntries.endSeq(),
+                  newlineCount == 0 ? 1 : countLines(entry.logMsg()),
+                  entry.ucTime);
+                if(reset) {
+                    ++statistics.detectedResetCount;
+                    closeBootFilters();
+                }
+
                 auto const ucSecs = std::chrono::duration<double>(entry.ucTime.time).count();
                 ucTimeDataMin     = std::min(ucTimeDataMin, ucSecs);
-                bool const newMax = ucSecs > ucTimeDataMax;
                 ucTimeDataMax     = std::max(ucTimeDataMax, ucSecs);
-                if(ucTimeLiveMode && newMax) {
-                    minUcTimeSec = std::max(0.0, ucTimeDataMax - ucTimeLiveWindowSecs);
-                    minUcTimeStr = fmt::format("{:.1f}", minUcTimeSec);
-                    maxUcTimeSec = std::numeric_limits<double>::infinity();
-                    maxUcTimeStr.clear();
-                    ucTimeFilterEnabled = true;
-                    updateFilteredLogEntries();
+                if(ucTimeLiveMode && (reset || bootIndex.latest().lastTime > lastTime)) {
+                    followLatestBoot();
                 }
             }
 
-            auto const metrics = uc_log::extractMetrics(recv_time, entry);
-            for(auto const& metric : metrics) {
-                metricEntries[metric.first].push_back(metric.second);
+            for(auto const& sample : entry.metrics.view()) {
+                metricSeries(sample.metric)
+                  .push_back(recv_time, uc_log::detail::toDouble(sample.value));
             }
 
-            std::size_t const newlineCount
-              = static_cast<std::size_t>(std::ranges::count(entry.logMsg, '\n'));
-            std::size_t const groupId = ++nextMultilineGroupId;
-
-            allSourceLocations[SourceLocation{entry.fileName, entry.line}]++;
+            countCallSiteLog(entry.callSite, true);
+            currentFilter.resolve(entry.callSite);
 
             if(newlineCount == 0) {
-                auto logEntry = std::make_shared<GuiLogEntry const>(
-                  GuiLogEntry{recv_time, entry, LineType::SingleLine, groupId});
-
-                allLogEntries.push_back(logEntry);
-                if(passesAllFilters(*logEntry)) {
-                    filteredLogEntries.push_back(logEntry);
+                auto const seq
+                  = allLogEntries.push_back(recv_time, entry, LineType::SingleLine, entry.logMsg());
+                ucTimeIndex.push_back(seq, entry.ucTime);
+                if(passesAllFilters(allLogEntries.at(seq))) {
+                    filteredLogEntries.push_back(seq);
                     ++filteredOriginalLogCount;
                 }
             } else {
-                auto const lines = splitIntoLines(entry.logMsg);
+                auto const lines = splitIntoLines(entry.logMsg());
 
                 // Check filter on first line entry
                 bool groupPassesFilter = false;
@@ -3036,33 +3795,29 @@ namespace uc_log { namespace FTXUIGui {
                         return LineType::Middle;
                     }();
 
-                    auto lineEntry   = entry;
-                    lineEntry.logMsg = line;
-
-                    auto const logEntry = std::make_shared<GuiLogEntry const>(
-                      GuiLogEntry{recv_time, lineEntry, lineType, groupId});
-
-                    allLogEntries.push_back(logEntry);
+                    auto const seq = allLogEntries.push_back(recv_time, entry, lineType, line);
+                    ucTimeIndex.push_back(seq, entry.ucTime);
 
                     // Check filter once on first line
                     if(i == 0) {
-                        groupPassesFilter = passesAllFilters(*logEntry);
+                        groupPassesFilter = passesAllFilters(allLogEntries.at(seq));
                         if(groupPassesFilter) { ++filteredOriginalLogCount; }
                     }
 
-                    if(groupPassesFilter) { filteredLogEntries.push_back(logEntry); }
+                    if(groupPassesFilter) { filteredLogEntries.push_back(seq); }
                 }
             }
 
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            enforceLogStoreLimits();
         }
 
+    public:
         void fatalError(std::string_view msg) {
             std::lock_guard<std::mutex> const lock{mutex};
             statusMessages.emplace_back(MessageEntry::Level::Fatal,
                                         std::chrono::system_clock::now(),
                                         std::string{msg});
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void statusMessage(std::string_view msg) {
@@ -3070,7 +3825,7 @@ namespace uc_log { namespace FTXUIGui {
             statusMessages.emplace_back(MessageEntry::Level::Status,
                                         std::chrono::system_clock::now(),
                                         std::string{msg});
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void errorMessage(std::string_view msg) {
@@ -3078,7 +3833,7 @@ namespace uc_log { namespace FTXUIGui {
             statusMessages.emplace_back(MessageEntry::Level::Error,
                                         std::chrono::system_clock::now(),
                                         std::string{msg});
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void toolStatusMessage(std::string_view msg) {
@@ -3086,7 +3841,7 @@ namespace uc_log { namespace FTXUIGui {
             statusMessages.emplace_back(MessageEntry::Level::ToolStatus,
                                         std::chrono::system_clock::now(),
                                         std::string{msg});
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void toolErrorMessage(std::string_view msg) {
@@ -3094,7 +3849,7 @@ namespace uc_log { namespace FTXUIGui {
             statusMessages.emplace_back(MessageEntry::Level::ToolError,
                                         std::chrono::system_clock::now(),
                                         std::string{msg});
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void setTcpPortStatus(TcpPortStatus s,
@@ -3103,7 +3858,7 @@ namespace uc_log { namespace FTXUIGui {
             tcpPortStatus  = s;
             tcpCurrentPort = p;
             if(tcpPortInput.empty()) { tcpPortInput = std::to_string(p); }
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void setOnTcpPortChange(std::function<void(std::uint16_t)> cb) {
@@ -3114,6 +3869,38 @@ namespace uc_log { namespace FTXUIGui {
             tcpClientCountGetter = std::move(getter);
         }
 
+        /// Upper bound on the frames drawn per second, 0 draws on every change.
+        void setMaxFps(unsigned fps) {
+            std::lock_guard<std::mutex> const lock{mutex};
+            maxFps = fps;
+        }
+
+        /// Budget of the log history, the oldest logs are dropped once either limit is exceeded.
+        /// 0 disables a limit.
+        void setLogStoreLimits(std::size_t maxEntries,
+                               std::size_t maxBytes) {
+            std::lock_guard<std::mutex> const lock{mutex};
+            logStoreLimits = uc_log::detail::LogStoreLimits{maxEntries, maxBytes};
+            enforceLogStoreLimits();
+        }
+
+        /// History kept per metric, the newest samples at full resolution and the buckets of each
+        /// coarser tier. Applies to metrics first seen after the call.
+        void setMetricSeriesLimits(std::size_t rawSamples,
+                                   std::size_t tierBuckets) {
+            std::lock_guard<std::mutex> const lock{mutex};
+            metricSeriesLimits.rawSamples  = rawSamples;
+            metricSeriesLimits.tierBuckets = tierBuckets;
+        }
+
+        void setQueueStatsGetter(std::function<ReorderQueueStats()> getter) {
+            queueStatsGetter = std::move(getter);
+        }
+
+        void setSinkStatsGetter(std::function<std::vector<SinkStats>()> getter) {
+            sinkStatsGetter = std::move(getter);
+        }
+
         void setLogFileStatus(LogFileStatus    s,
                               std::string_view path) {
             std::lock_guard<std::mutex> const lock{mutex};
@@ -3123,7 +3910,7 @@ namespace uc_log { namespace FTXUIGui {
                 logDirInput = std::filesystem::path{path}.parent_path().string();
             }
             if(exportDirInput.empty()) { exportDirInput = logDirInput; }
-            if(screenPointer != nullptr) { screenPointer->PostEvent(ftxui::Event::Custom); }
+            requestRedraw();
         }
 
         void setOnLogDirChange(std::function<void(std::string const&)> cb) {
@@ -3150,6 +3937,8 @@ namespace uc_log { namespace FTXUIGui {
 
                 mainComponent
                   = ftxui::CatchEvent(getTabComponent(rttReader), [&](ftxui::Event const& event) {
+                        if(event != ftxui::Event::Custom) { inputReceived = true; }
+
                         // Only block hotkeys when actively typing in a text input field
                         if(event.is_character()
                            && ((manualLocationInput && manualLocationInput->Focused())
@@ -3231,12 +4020,22 @@ namespace uc_log { namespace FTXUIGui {
                         return false;
                     });
             }
-            ftxui::Loop loop(&screen, mainComponent);
+            auto frameComponent = ftxui::Renderer(
+              mainComponent, [this, mainComponent]() { return drawFrame(mainComponent); });
+            ftxui::Loop loop(&screen, frameComponent);
 
+            setSplicing(true);
             while(!loop.HasQuitted()) {
                 {
                     std::lock_guard<std::mutex> const lock{mutex};
                     updateJLinkStatistics(rttReader);
+                    spliceStagedEntries();
+                    applyFilterRebuild();
+                    // one wake-up for everything that changed since the last iteration
+                    if(screenPointer != nullptr && isFrameDue(std::chrono::steady_clock::now())) {
+                        screenPointer->PostEvent(ftxui::Event::Custom);
+                        ++statistics.wakeupsPosted;
+                    }
                     loop.RunOnce();
                     if(screenPointer == nullptr) { screenPointer = &screen; }
                 }
@@ -3249,6 +4048,7 @@ namespace uc_log { namespace FTXUIGui {
                 }
                 if(triggerFlashNow.exchange(false)) { flashWithStats(rttReader); }
             }
+            setSplicing(false);
             {
                 std::lock_guard<std::mutex> const lock{mutex};
                 screenPointer = nullptr;
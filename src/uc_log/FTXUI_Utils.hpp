@@ -1,12 +1,15 @@
 #pragma once
 
+#include "uc_log/detail/BootIndex.hpp"
 #include "uc_log/detail/LogEntry.hpp"
+#include "uc_log/detail/MetricSeries.hpp"
 #include "uc_log/metric_utils.hpp"
 #include "uc_log/theme.hpp"
 
 #include <algorithm>
 #include <array>
 #include <charconv>
+#include <chrono>
 #ifdef __GNUC__
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Wextra-semi"
@@ -27,9 +30,11 @@
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/component_base.hpp>
 #include <ftxui/component/event.hpp>
+#include <ftxui/dom/canvas.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <ftxui/screen/box.hpp>
 #include <ftxui/screen/screen.hpp>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -46,6 +51,28 @@ namespace uc_log { namespace FTXUIGui {
         static constexpr std::size_t MaxChannels    = 6;
         static constexpr auto        UpdateInterval = std::chrono::milliseconds{10};
         static constexpr std::size_t MaxLogEntries  = 10'000'000;
+        static constexpr std::size_t MaxLogBytes    = std::size_t{4} << 30;
+
+        // filter rebuilds of stores with at least this many lines run on the worker pool
+        static constexpr std::size_t ParallelFilterThreshold = std::size_t{1} << 20;
+
+        // rendered log rows kept between frames, a few screens worth
+        static constexpr std::size_t RenderCacheSize = 2048;
+
+        // frames are drawn at most DefaultMaxFps times per second and at least once per
+        // IdleRedrawInterval, which keeps polled values such as rates and uptimes current
+        static constexpr unsigned DefaultMaxFps      = 30;
+        static constexpr auto     IdleRedrawInterval = std::chrono::milliseconds{500};
+
+        // entries add() may stage ahead of the gui thread before it waits for the next frame
+        static constexpr std::size_t MaxStagedEntries = std::size_t{1} << 18;
+
+        // per metric: 4096 raw samples and 4 tiers of 1024 buckets of 8^n samples, about 384KiB
+        // covering the last 4M samples, e.g. 11h of a metric logged at 100Hz
+        static constexpr std::size_t MetricRawSamples  = 4096;
+        static constexpr std::size_t MetricTierBuckets = 1024;
+        static constexpr std::size_t MetricTierFactor  = 8;
+        static constexpr std::size_t MetricTiers       = 4;
     }   // namespace GUI_Constants
 
     namespace util {
@@ -166,9 +193,25 @@ namespace uc_log { namespace FTXUIGui {
 
         ftxui::Element getMetadataContent() const { return metadataContent_; }
 
+        // the content does not change, so its width is only computed once
+        int getContentWidth() {
+            if(!contentWidth_.has_value()) {
+                scrollableContent_->ComputeRequirement();
+                contentWidth_ = scrollableContent_->requirement().min_x;
+            }
+            return *contentWidth_;
+        }
+
     private:
-        ftxui::Element scrollableContent_;
-        ftxui::Element metadataContent_;
+        ftxui::Element     scrollableContent_;
+        ftxui::Element     metadataContent_;
+        std::optional<int> contentWidth_;
+    };
+
+    // shared between a Scroller and its owner
+    struct ScrollerState {
+        std::optional<std::size_t> jumpTarget;        // selected on the next render, then cleared
+        bool                       following{true};   // the newest entry is selected
     };
 
     template<typename ContainerGetter, typename Transform>
@@ -176,17 +219,27 @@ namespace uc_log { namespace FTXUIGui {
     public:
         ContainerGetter containerGetter_;
         Transform       transform_;
+        ScrollerState*  state_;
 
         ScrollerBase(ContainerGetter&& containerGetter,
-                     Transform&&       transformFunc)
+                     Transform&&       transformFunc,
+                     ScrollerState*    state = nullptr)
           : containerGetter_{containerGetter}
-          , transform_{transformFunc} {}
+          , transform_{transformFunc}
+          , state_{state} {}
 
     private:
         ftxui::Element OnRender() final {
             auto const& container = containerGetter_();
             containerSize         = static_cast<int>(container.size());
             int const ySpace      = (renderBox.y_max - renderBox.y_min) + 2;
+            if(state_ != nullptr && state_->jumpTarget.has_value()) {
+                selectedIndex = static_cast<int>(std::min(
+                  *state_->jumpTarget, static_cast<std::size_t>(std::max(containerSize - 1, 0))));
+                stick         = selectedIndex >= containerSize - 1;
+                state_->jumpTarget.reset();
+            }
+            if(state_ != nullptr) { state_->following = stick; }
             selectedIndex         = std::max(0, std::min(containerSize - 1, selectedIndex));
             if(stick) { selectedIndex = containerSize - 1; }
 
@@ -242,19 +295,18 @@ namespace uc_log { namespace FTXUIGui {
 
                 ftxui::Element scrollableContent;
                 ftxui::Element metadataForThisRow;
+                // Compute and store content width for this line
                 if constexpr(!std::is_same_v<decltype(transformedElement), ftxui::Element>) {
                     scrollableContent  = transformedElement->getScrollableContent();
                     metadataForThisRow = transformedElement->getMetadataContent();
-
+                    lineContentWidths.push_back(transformedElement->getContentWidth());
                 } else {
                     scrollableContent  = transformedElement;
                     metadataForThisRow = ftxui::text("");
+                    scrollableContent->ComputeRequirement();
+                    lineContentWidths.push_back(scrollableContent->requirement().min_x);
                 }
 
-                // Compute and store content width for this line
-                scrollableContent->ComputeRequirement();
-                lineContentWidths.push_back(scrollableContent->requirement().min_x);
-
                 if(isCurrentItem) {
                     auto const selectedStyle
                       = Focused() && !stick ? ftxui::inverted : ftxui::nothing;
@@ -466,6 +518,7 @@ namespace uc_log { namespace FTXUIGui {
 
             if(selectedIndex >= containerSize - 1) { stick = true; }
             selectedIndex = std::max(0, std::min(containerSize - 1, selectedIndex));
+            if(state_ != nullptr) { state_->following = stick; }
 
             return previousSelected != selectedIndex
                 || previousHorizontalOffset != horizontalOffset;
@@ -483,10 +536,12 @@ namespace uc_log { namespace FTXUIGui {
     template<typename ContainerGetter,
              typename Transform>
     ftxui::Component Scroller(ContainerGetter&& containerGetter,
-                              Transform&&       transformFunc) {
+                              Transform&&       transformFunc,
+                              ScrollerState*    state = nullptr) {
         return ftxui::Make<ScrollerBase<ContainerGetter, Transform>>(
           std::forward<ContainerGetter>(containerGetter),
-          std::forward<Transform>(transformFunc));
+          std::forward<Transform>(transformFunc),
+          state);
     }
 
     inline ftxui::Element toElement(uc_log::detail::LogEntry::Channel const& channel) {
@@ -528,18 +583,19 @@ namespace uc_log { namespace FTXUIGui {
     using SourceLocation = std::pair<std::string, std::size_t>;
 
     struct SourceLocationAdapter : ftxui::ConstStringListRef::Adapter {
-        SourceLocationAdapter(std::map<SourceLocation,
-                                       std::size_t>& container_)
-          : container{container_} {}
+        // `container_` returns the up to date locations, it is called on every read
+        explicit SourceLocationAdapter(
+          std::function<std::map<SourceLocation, std::size_t>&()> container_)
+          : container{std::move(container_)} {}
 
         std::size_t size() const override {
             string_storage.clear();   // Clear at start of render pass
-            return container.size();
+            return container().size();
         }
 
         std::string_view operator[](std::size_t index) const override {
             // Always compute fresh string
-            auto const iter = std::next(container.begin(), static_cast<int>(index));
+            auto const iter = std::next(container().begin(), static_cast<int>(index));
 
             auto const& [sourceLocation, count] = *iter;
             auto const& [fileName, lineNumber]  = sourceLocation;
@@ -552,8 +608,8 @@ namespace uc_log { namespace FTXUIGui {
             return inserted_it->second;
         }
 
-        std::map<SourceLocation, std::size_t>&     container;
-        mutable std::map<std::size_t, std::string> string_storage;
+        std::function<std::map<SourceLocation, std::size_t>&()> container;
+        mutable std::map<std::size_t, std::string>              string_storage;
     };
 
     struct EnabledLocationAdapter : ftxui::ConstStringListRef::Adapter {
@@ -585,6 +641,34 @@ namespace uc_log { namespace FTXUIGui {
         mutable std::map<std::size_t, std::string> string_storage;
     };
 
+    struct BootListAdapter : ftxui::ConstStringListRef::Adapter {
+        BootListAdapter(uc_log::detail::BootIndex const& bootIndex_) : bootIndex{bootIndex_} {}
+
+        std::size_t size() const override {
+            string_storage.clear();   // Clear at start of render pass
+            return bootIndex.boots().size();
+        }
+
+        std::string_view operator[](std::size_t index) const override {
+            auto const& boot = bootIndex.boots()[index];
+            auto const  secs = [](std::chrono::nanoseconds time) {
+                return std::chrono::duration<double>(time).count();
+            };
+
+            auto [inserted_it, inserted] = string_storage.emplace(
+              index,
+              fmt::format("#{}  {:.1f} – {:.1f} s  {} logs",
+                          boot.number,
+                          secs(boot.firstTime),
+                          secs(boot.lastTime),
+                          boot.logCount));
+            return inserted_it->second;
+        }
+
+        uc_log::detail::BootIndex const&           bootIndex;
+        mutable std::map<std::size_t, std::string> string_storage;
+    };
+
     static ftxui::Element ansiColoredTextToFtxui(std::string_view text) {
         static constexpr char escape = '\x1B';
 
@@ -889,11 +973,10 @@ namespace uc_log { namespace FTXUIGui {
             return TimeUnit::Hours;
         }
 
-        std::chrono::seconds analyzeDataTimeSpan(std::vector<MetricEntry> const& values) const {
-            if(values.empty()) { return std::chrono::seconds(0); }
-            auto oldest = values.front().recv_time;
-            auto newest = values.back().recv_time;
-            return std::chrono::duration_cast<std::chrono::seconds>(newest - oldest);
+        std::chrono::seconds analyzeDataTimeSpan(detail::MetricSeries const& series) const {
+            if(series.empty()) { return std::chrono::seconds(0); }
+            return std::chrono::duration_cast<std::chrono::seconds>(series.latest().time
+                                                                    - series.begin());
         }
 
         std::string formatMetricValue(double             value,
@@ -981,14 +1064,13 @@ namespace uc_log { namespace FTXUIGui {
             return labels;
         }
 
-        std::vector<std::string> generateXAxisLabels(std::vector<MetricEntry> const& values,
-                                                     std::size_t                     startIdx,
+        std::vector<std::string> generateXAxisLabels(detail::MetricSeries const& series,
+                                                     std::size_t                 level,
+                                                     std::size_t                 startIdx,
                                                      std::size_t visibleDataSize) const {
             std::vector<std::string> labels;
 
-            if(values.empty() || visibleDataSize < 2 || startIdx >= values.size()) {
-                return labels;
-            }
+            if(visibleDataSize < 2 || startIdx >= series.size(level)) { return labels; }
 
             auto currentTime = std::chrono::system_clock::now();
 
@@ -1005,8 +1087,9 @@ namespace uc_log { namespace FTXUIGui {
                                 / static_cast<std::size_t>(numTicks - 1);
                 }
 
-                if(dataIdx < values.size()) {
-                    auto timeLabel = formatTimeLabel(currentTime, values[dataIdx].recv_time);
+                if(dataIdx < series.size(level)) {
+                    auto timeLabel
+                      = formatTimeLabel(currentTime, series.point(level, dataIdx).last);
                     labels.push_back(timeLabel);
                 }
             }
@@ -1049,39 +1132,56 @@ namespace uc_log { namespace FTXUIGui {
             return {center - halfRange, center + halfRange};
         }
 
-        std::pair<std::size_t,
-                  std::size_t>
-        calculateXAxisDataRange(std::vector<MetricEntry> const& values) const {
-            if(values.empty()) { return {0, 0}; }
-
-            std::size_t const dataSize = values.size();
-            std::size_t       startIdx = 0;
-            std::size_t       endIdx{};
-
+        // time from which on the series is shown
+        detail::MetricSeries::TimePoint visibleBegin(detail::MetricSeries const& series) const {
             switch(config_.timeRangeMode) {
-            case TimeRangeMode::ShowAll:
-                startIdx = 0;
-                endIdx   = dataSize;
-                break;
-
+            case TimeRangeMode::ShowAll: return series.begin();
             case TimeRangeMode::LastPeriod:
-                {
-                    auto timeWindow
-                      = timeUnitToSeconds(config_.timePeriodValue, config_.timePeriodUnit);
-                    auto cutoffTime = std::chrono::system_clock::now() - timeWindow;
+                return std::chrono::system_clock::now()
+                     - timeUnitToSeconds(config_.timePeriodValue, config_.timePeriodUnit);
+            }
+            return series.begin();
+        }
 
-                    for(std::size_t i = 0; i < dataSize; ++i) {
-                        if(values[i].recv_time >= cutoffTime) {
-                            startIdx = i;
-                            break;
-                        }
-                    }
-                    endIdx = dataSize;
-                    break;
+        // draws the smallest to the largest value of the points behind every pixel column, so a
+        // single spike stays visible however many points share a column
+        static void drawEnvelope(ftxui::Canvas&                  canvas,
+                                 detail::MetricSeries const&     series,
+                                 detail::MetricSeries::TimePoint begin,
+                                 double                          yMin,
+                                 double                          yMax) {
+            auto const level  = series.levelSince(begin);
+            auto const first  = series.lowerBound(level, begin);
+            auto const count  = series.size(level) - first;
+            auto const width  = static_cast<std::size_t>(std::max(canvas.width(), 0));
+            auto const height = canvas.height();
+            if(width == 0 || height <= 0 || count == 0) { return; }
+
+            double const yRange = yMax != yMin ? yMax - yMin : 1.0;
+            auto const   toY    = [&](double value) {
+                double const normalized = std::clamp((yMax - value) / yRange, 0.0, 1.0);
+                return static_cast<int>(normalized * (height - 1));
+            };
+
+            std::optional<std::pair<int, int>> previous;
+            for(std::size_t x{}; x < width; ++x) {
+                auto const from = first + (x * count) / width;
+                auto const to   = std::max(from + 1, first + ((x + 1) * count) / width);
+
+                auto const extent = series.extent(level, from, to);
+                int        top    = toY(extent.max);
+                int        bottom = toY(extent.min);
+                auto const column = std::pair{top, bottom};
+                // join the span of the column before, steps read as a line and not as dots
+                if(previous) {
+                    top    = std::min(top, previous->second);
+                    bottom = std::max(bottom, previous->first);
                 }
-            }
+                previous = column;
 
-            return {startIdx, endIdx};
+                auto const xPos = static_cast<int>(x);
+                canvas.DrawPointLine(xPos, top, xPos, bottom);
+            }
         }
 
     public:
@@ -1103,7 +1203,8 @@ namespace uc_log { namespace FTXUIGui {
         std::optional<MetricInfo> const& getSelectedMetric() const { return selectedMetric_; }
 
         [[nodiscard]] ftxui::Component createControlsComponent() {
-            return createControlsWithData([]() { return std::vector<MetricEntry>{}; });
+            return createControlsWithData(
+              []() { return std::optional<detail::MetricSeries const*>{}; });
         }
 
         template<typename MetricDataProvider>
@@ -1208,11 +1309,13 @@ namespace uc_log { namespace FTXUIGui {
                     return ftxui::vbox(noDataElements);
                 }
 
-                auto const& values = **metricData;
+                auto const& series = **metricData;
                 auto const& info   = *selectedMetric_;
 
-                auto [xStartIdx, xEndIdx]         = calculateXAxisDataRange(values);
-                std::size_t const visibleDataSize = xEndIdx - xStartIdx;
+                auto const        begin           = visibleBegin(series);
+                auto const        level           = series.levelSince(begin);
+                auto const        xStartIdx       = series.lowerBound(level, begin);
+                std::size_t const visibleDataSize = series.size(level) - xStartIdx;
 
                 if(visibleDataSize == 0) {
                     ftxui::Elements const noRangeElements
@@ -1223,53 +1326,19 @@ namespace uc_log { namespace FTXUIGui {
                     return ftxui::vbox(noRangeElements);
                 }
 
-                double dataMinVal = values[xStartIdx].value;
-                double dataMaxVal = values[xStartIdx].value;
-                for(std::size_t i = xStartIdx; i < xEndIdx; ++i) {
-                    dataMinVal = std::min(dataMinVal, values[i].value);
-                    dataMaxVal = std::max(dataMaxVal, values[i].value);
-                }
+                auto const extent = series.extent(level, xStartIdx, series.size(level));
 
-                auto [yMin, yMax] = calculateYAxisRange(dataMinVal, dataMaxVal);
-
-                auto graphFunc = [values, xStartIdx, xEndIdx, visibleDataSize, yMin, yMax](
-                                   int width,
-                                   int height) -> std::vector<int> {
-                    std::vector<int> output(static_cast<std::size_t>(width), height / 2);
-
-                    if(visibleDataSize == 0 || width <= 0) { return output; }
-
-                    double yRange = yMax - yMin;
-                    if(yRange == 0.0) { yRange = 1.0; }
+                auto [yMin, yMax] = calculateYAxisRange(extent.min, extent.max);
 
-                    for(int xPos = 0; xPos < width; ++xPos) {
-                        std::size_t dataIdx{};
-                        if(visibleDataSize == 1) {
-                            dataIdx = xStartIdx;
-                        } else {
-                            dataIdx = xStartIdx
-                                    + (static_cast<std::size_t>(xPos) * (visibleDataSize - 1))
-                                        / static_cast<std::size_t>(width - 1);
-                        }
+                // reads the series when drawn, which happens under the gui lock like every change
+                auto graph = ftxui::canvas([&series, begin, yMin, yMax](ftxui::Canvas& canvas) {
+                    drawEnvelope(canvas, series, begin, yMin, yMax);
+                }) | ftxui::color(Theme::Header::accent());
 
-                        if(dataIdx < xEndIdx) {
-                            double normalizedValue = (values[dataIdx].value - yMin) / yRange;
-                            normalizedValue        = std::clamp(normalizedValue, 0.0, 1.0);
-                            int const yPos = static_cast<int>(normalizedValue * (height - 1));
-                            output[static_cast<std::size_t>(xPos)]
-                              = std::clamp(yPos, 0, height - 1);
-                        }
-                    }
-
-                    return output;
-                };
-
-                auto graph = ftxui::graph(graphFunc) | ftxui::color(Theme::Header::accent());
-
-                if(values.size() < 2) { return graph; }
+                if(series.totalCount() < 2) { return graph; }
 
                 auto yLabels = generateYAxisLabels(yMin, yMax, config_.minHeight, info.unit);
-                auto xLabels = generateXAxisLabels(values, xStartIdx, visibleDataSize);
+                auto xLabels = generateXAxisLabels(series, level, xStartIdx, visibleDataSize);
 
                 ftxui::Elements yLabelElements;
                 for(std::size_t i = 0; i < yLabels.size(); ++i) {
@@ -1314,22 +1383,20 @@ namespace uc_log { namespace FTXUIGui {
                 auto metricData = capturedDataProvider(*selectedMetric_);
                 if(!metricData || (*metricData)->empty()) { return ftxui::text(""); }
 
-                auto const& values = **metricData;
+                auto const& series = **metricData;
                 auto const& info   = *selectedMetric_;
 
-                auto [statsStartIdx, statsEndIdx] = calculateXAxisDataRange(values);
-                std::size_t visibleStatsSize      = statsEndIdx - statsStartIdx;
+                auto const begin         = visibleBegin(series);
+                auto const level         = series.levelSince(begin);
+                auto const statsStartIdx = series.lowerBound(level, begin);
+                auto const statsEndIdx   = series.size(level);
+                if(statsStartIdx == statsEndIdx) { return ftxui::text(""); }
 
-                if(visibleStatsSize == 0) { return ftxui::text(""); }
-
-                double       dataMinVal = values[statsStartIdx].value;
-                double       dataMaxVal = values[statsStartIdx].value;
-                double const latestVal  = values[statsEndIdx - 1].value;
-
-                for(std::size_t i = statsStartIdx; i < statsEndIdx; ++i) {
-                    dataMinVal = std::min(dataMinVal, values[i].value);
-                    dataMaxVal = std::max(dataMaxVal, values[i].value);
-                }
+                auto const   visibleStatsSize = series.samples(level, statsStartIdx, statsEndIdx);
+                auto const   extent           = series.extent(level, statsStartIdx, statsEndIdx);
+                double const dataMinVal       = extent.min;
+                double const dataMaxVal       = extent.max;
+                double const latestVal        = series.latest().value;
 
                 auto [yMin, yMax] = calculateYAxisRange(dataMinVal, dataMaxVal);
 
@@ -1357,7 +1424,7 @@ namespace uc_log { namespace FTXUIGui {
                   ftxui::text(" to ") | ftxui::color(Theme::Data::value()),
                   ftxui::text(formatMetricValue(yMax, "")) | ftxui::color(Theme::Data::value()),
                   ftxui::text(" | Visible: ") | ftxui::bold,
-                  ftxui::text(fmt::format("{}/{}", visibleStatsSize, values.size()))
+                  ftxui::text(fmt::format("{}/{}", visibleStatsSize, series.totalCount()))
                     | ftxui::color(Theme::Data::count()),
                 };
 
@@ -1403,7 +1470,7 @@ namespace uc_log { namespace FTXUIGui {
         }
     };
 
-    static inline std::string formatNumber(std::uint32_t num) {
+    static inline std::string formatNumber(std::uint64_t num) {
         if(num >= 1000000) { return fmt::format("{}M", num / 1000000); }
         if(num >= 1000) { return fmt::format("{}K", num / 1000); }
         return std::to_string(num);
@@ -2,11 +2,20 @@
 #include "jlink/JLink.hpp"
 #include "remote_fmt/remote_fmt.hpp"
 #include "uc_log/RttBlockInfo.hpp"
+#include "uc_log/RttPipelineStats.hpp"
+#include "uc_log/detail/PollScheduler.hpp"
+#include "uc_log/detail/RttChannelParser.hpp"
+#include "uc_log/detail/RttRawFormat.hpp"
+#include "uc_log/detail/SpscByteRing.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <functional>
+#include <memory>
 #include <span>
+#include <stop_token>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -16,69 +25,167 @@ private:
     using Clock = std::chrono::steady_clock;
 
     static constexpr std::size_t RttBufferChunkSize = 32768;
-    static constexpr auto        RttTimeout         = std::chrono::milliseconds{100};
-
-    struct Channel {
-        std::vector<std::byte> buffer;
-        Clock::time_point      lastValidRead{Clock::now()};
-        Clock::time_point      lastHaltDetected{};
-
-        void read(JLink&        jlink,
-                  std::uint32_t channel) {
-            auto const oldSize = buffer.size();
-            buffer.resize(oldSize + RttBufferChunkSize);
-            auto span      = std::span{buffer};
-            span           = span.subspan(oldSize);
-            auto const ret = jlink.rttRead(channel, span);
-            buffer.resize(oldSize + ret.size());
+    static constexpr std::size_t RttRingSize        = 1 << 20;
+
+    // bounds what a crash or a killed process loses from a raw capture
+    static constexpr std::chrono::milliseconds CaptureFlushInterval{250};
+
+public:
+    using PollConfig = uc_log::detail::PollScheduler::Config;
+
+private:
+    struct PipelineCounters {
+        std::atomic<std::uint64_t> polledBytes{};
+        std::atomic<std::uint64_t> parsedBytes{};
+        std::atomic<std::uint64_t> parsedMessages{};
+        std::atomic<std::uint64_t> ringFullEvents{};
+        std::atomic<std::uint64_t> pollBusyNs{};
+        std::atomic<std::uint64_t> parseBusyNs{};
+        std::atomic<std::size_t>   maxRingFill{};
+        std::atomic<std::size_t>   parserThreads{};
+        std::atomic<double>        polledBytesPerSecond{};
+        std::atomic<double>        parsedMessagesPerSecond{};
+        std::atomic<double>        pollLoad{};
+        std::atomic<double>        parseLoad{};
+        std::atomic<std::uint64_t> pollIntervalUs{};
+        std::atomic<double>        overflowsPerSecond{};
+    };
+
+    struct RateWindow {
+        Clock::time_point start{Clock::now()};
+        std::uint64_t     polledBytes{};
+        std::uint64_t     parsedMessages{};
+        std::uint64_t     pollBusyNs{};
+        std::uint64_t     parseBusyNs{};
+    };
+
+    // The reader thread only moves bytes from the probe into one ring per channel, the parser
+    // threads own everything behind the rings. Each channel is served by exactly one parser
+    // thread so every ring keeps a single consumer.
+    struct ParserStage {
+        std::vector<std::unique_ptr<uc_log::detail::SpscByteRing>> rings;
+        std::vector<uc_log::detail::RttChannelParser>              parsers;
+        std::atomic<std::uint32_t>                                 generation{};
+        std::atomic<Clock::time_point>                             lastMessage{Clock::now()};
+        std::atomic<Clock::time_point>                             lastHaltDetected{};
+        std::atomic<bool>                                          failed{};
+        std::vector<std::jthread>                                  threads;
+
+        void wake() {
+            generation.fetch_add(1, std::memory_order_release);
+            generation.notify_all();
         }
+    };
 
-        bool run(std::stop_token&                             stoken,
-                 JLink&                                       jlink,
-                 std::function<void(std::size_t,
-                                    std::string_view)> const& printF,
-                 std::uint32_t                                channel,
-                 std::unordered_map<std::uint16_t,
-                                    std::string> const&       stringConstantsMap,
-                 std::function<void(std::string_view)> const& errorMessagef) {
-            read(jlink, channel);
-            bool gotMessage{};
-            if(!buffer.empty()) {
-                while(!stoken.stop_requested()) {
-                    auto const [output_stream, subrange, unparsed_bytes]
-                      = remote_fmt::parse(buffer, stringConstantsMap, errorMessagef);
-                    buffer.erase(buffer.begin(),
-                                 std::next(buffer.begin(),
-                                           static_cast<std::make_signed_t<std::size_t>>(
-                                             buffer.size() - subrange.size())));
-                    if(unparsed_bytes != 0) {
-                        errorMessagef(fmt::format("channel {} corrupted data removed {} byte{}",
-                                                  channel,
-                                                  unparsed_bytes,
-                                                  unparsed_bytes == 1 ? "" : "s"));
-                    }
-                    if(output_stream) {
-                        lastValidRead = Clock::now();
-                        gotMessage    = true;
-                        printF(channel, *output_stream);
-                        continue;
+    static std::uint64_t toNs(Clock::duration d) {
+        return static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    std::size_t poll(JLink&                        jlink,
+                     uc_log::detail::SpscByteRing& ring,
+                     std::uint32_t                 channel) {
+        std::size_t polled{};
+        // a wrapped ring hands out its free space in two pieces
+        for(int piece{}; piece < 2; ++piece) {
+            auto space = ring.prepareWrite();
+            if(space.empty()) {
+                counters.ringFullEvents.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            space          = space.first(std::min(space.size(), RttBufferChunkSize));
+            auto const ret = jlink.rttRead(channel, space);
+            ring.commitWrite(ret.size());
+            if(capture.isOpen() && !ret.empty()) { capture.writeChunk(channel, ret); }
+            polled += ret.size();
+            if(ret.size() < space.size()) { break; }
+        }
+
+        auto const fill = ring.size();
+        auto       max  = counters.maxRingFill.load(std::memory_order_relaxed);
+        while(fill > max
+              && !counters.maxRingFill.compare_exchange_weak(max, fill, std::memory_order_relaxed))
+        {}
+        return polled;
+    }
+
+    void parse(std::stop_token const&                     stoken,
+               ParserStage&                               stage,
+               std::unordered_map<std::uint16_t,
+                                  std::string> const&     stringConstantsMap,
+               std::size_t                                firstChannel,
+               std::size_t                                channelStride) {
+        std::stop_callback const wakeOnStop{stoken, [&stage]() { stage.wake(); }};
+        try {
+            while(!stoken.stop_requested()) {
+                auto const seen  = stage.generation.load(std::memory_order_acquire);
+                auto const start = Clock::now();
+
+                std::size_t bytes{};
+                std::size_t messages{};
+                for(auto channel = firstChannel; channel < stage.parsers.size();
+                    channel += channelStride)
+                {
+                    auto& ring   = *stage.rings[channel];
+                    auto& parser = stage.parsers[channel];
+                    for(auto chunk = ring.readable(); !chunk.empty(); chunk = ring.readable()) {
+                        parser.append(chunk);
+                        ring.consume(chunk.size());
+                        bytes += chunk.size();
                     }
-                    break;
+                    messages += parser.parse(stoken,
+                                             static_cast<std::uint32_t>(channel),
+                                             stringConstantsMap,
+                                             entryPrintCallback,
+                                             errorMessageCallback);
+                    parser.dropStaleByte(static_cast<std::uint32_t>(channel),
+                                         stage.lastHaltDetected.load(std::memory_order_relaxed),
+                                         errorMessageCallback);
                 }
-                if(jlink.isHalted()) { lastHaltDetected = Clock::now(); }
-                if((Clock::now() > lastValidRead + RttTimeout)
-                   && (Clock::now() > lastHaltDetected + std::chrono::seconds{60})
-                   && !buffer.empty())
-                {
-                    buffer.erase(buffer.begin());
-                    errorMessagef(fmt::format("channel {} timeout removed 1 byte", channel));
+
+                if(messages != 0) {
+                    stage.lastMessage.store(Clock::now(), std::memory_order_relaxed);
                 }
-            } else {
-                lastValidRead = Clock::now();
+                counters.parsedBytes.fetch_add(bytes, std::memory_order_relaxed);
+                counters.parsedMessages.fetch_add(messages, std::memory_order_relaxed);
+                counters.parseBusyNs.fetch_add(toNs(Clock::now() - start),
+                                               std::memory_order_relaxed);
+
+                if(bytes == 0) { stage.generation.wait(seen, std::memory_order_acquire); }
             }
-            return gotMessage;
+        } catch(std::exception const& e) {
+            toolErrorMessageCallback(fmt::format("parser caught {}", e.what()));
+            stage.failed = true;
         }
-    };
+    }
+
+    void updatePipelineRates(RateWindow& window) {
+        auto const now     = Clock::now();
+        auto const elapsed = now - window.start;
+        if(elapsed < std::chrono::seconds{1}) { return; }
+
+        auto const seconds        = std::chrono::duration<double>(elapsed).count();
+        auto const polledBytes    = counters.polledBytes.load(std::memory_order_relaxed);
+        auto const parsedMessages = counters.parsedMessages.load(std::memory_order_relaxed);
+        auto const pollBusyNs     = counters.pollBusyNs.load(std::memory_order_relaxed);
+        auto const parseBusyNs    = counters.parseBusyNs.load(std::memory_order_relaxed);
+        auto const parserThreads
+          = std::max(counters.parserThreads.load(std::memory_order_relaxed), std::size_t{1});
+
+        counters.polledBytesPerSecond.store(
+          static_cast<double>(polledBytes - window.polledBytes) / seconds,
+          std::memory_order_relaxed);
+        counters.parsedMessagesPerSecond.store(
+          static_cast<double>(parsedMessages - window.parsedMessages) / seconds,
+          std::memory_order_relaxed);
+        counters.pollLoad.store(static_cast<double>(pollBusyNs - window.pollBusyNs) / 1e9 / seconds,
+                                std::memory_order_relaxed);
+        counters.parseLoad.store(static_cast<double>(parseBusyNs - window.parseBusyNs) / 1e9
+                                   / (seconds * static_cast<double>(parserThreads)),
+                                 std::memory_order_relaxed);
+
+        window = RateWindow{now, polledBytes, parsedMessages, pollBusyNs, parseBusyNs};
+    }
 
     void run(std::stop_token stoken) {
         auto setStatusNotRunning = [&]() {
@@ -97,6 +204,23 @@ private:
                         pendingHost.reset();
                     }
                 }
+                {
+                    std::lock_guard<std::mutex> lock{captureMutex};
+                    if(pendingCapturePath) {
+                        capture.close();
+                        if(!pendingCapturePath->empty()) {
+                            if(capture.open(*pendingCapturePath)) {
+                                toolMessageCallback(
+                                  fmt::format("capturing raw rtt to {:?}", *pendingCapturePath));
+                            } else {
+                                toolErrorMessageCallback(fmt::format(
+                                  "failed to open raw capture file: {:?}",
+                                  *pendingCapturePath));
+                            }
+                        }
+                        pendingCapturePath.reset();
+                    }
+                }
                 jlinkResetFlag = false;
                 JLink jlink    = [&]() {
                     if(host.empty()) {
@@ -136,28 +260,65 @@ private:
                 auto const blockInfo    = blockInfoCallback();
                 auto const numChannels_ = blockInfo.numUpBuffers;
                 jlink.startRtt(numChannels_, blockInfo.address);
-                std::vector<Channel> channels{};
-                channels.resize(numChannels_);
-                auto lastMessage      = Clock::now();
-                auto lastHaltDetected = Clock::time_point{};
+                if(capture.isOpen()) {
+                    capture.writeSession(uc_log::detail::rttraw::catalogHash(stringConstantsMap),
+                                         numChannels_);
+                }
+
+                ParserStage stage{};
+                for(std::size_t i{}; i < numChannels_; ++i) {
+                    stage.rings.push_back(
+                      std::make_unique<uc_log::detail::SpscByteRing>(RttRingSize));
+                }
+                stage.parsers.resize(numChannels_);
+
+                auto const parserThreads = std::clamp<std::size_t>(
+                  parserThreadCount.load(std::memory_order_relaxed),
+                  1,
+                  std::max<std::size_t>(numChannels_, 1));
+                counters.parserThreads.store(parserThreads, std::memory_order_relaxed);
+                for(std::size_t i{}; i < parserThreads; ++i) {
+                    stage.threads.emplace_back(
+                      [this, &stage, &stringConstantsMap, i, parserThreads](
+                        std::stop_token pstoken) {
+                          parse(pstoken, stage, stringConstantsMap, i, parserThreads);
+                      });
+                }
+                RateWindow rateWindow{};
+                auto       lastCaptureFlush = Clock::now();
+
+                uc_log::detail::PollScheduler scheduler{getPollConfig()};
+                scheduler.reset(numChannels_);
+                std::vector<std::size_t> sweepBytes(numChannels_);
+
+                auto const timedOut = [&]() {
+                    auto const now = Clock::now();
+                    return (now > stage.lastMessage.load(std::memory_order_relaxed)
+                                    + std::chrono::seconds{noLogTimeoutSeconds_})
+                        && (now > stage.lastHaltDetected.load(std::memory_order_relaxed)
+                                    + std::chrono::seconds{60});
+                };
 
                 while(!stoken.stop_requested() && !jlinkResetFlag && !targetResetFlag && !flashFlag
-                      && !((Clock::now() > lastMessage + std::chrono::seconds{noLogTimeoutSeconds_})
-                           && (Clock::now() > lastHaltDetected + std::chrono::seconds{60})))
+                      && !stage.failed && !timedOut())
                 {
-                    for(std::size_t channelId{}; auto& channel : channels) {
-                        if(channel.run(stoken,
-                                       jlink,
-                                       entryPrintCallback,
-                                       static_cast<std::uint32_t>(channelId++),
-                                       stringConstantsMap,
-                                       errorMessageCallback))
-                        {
-                            lastMessage = Clock::now();
-                        }
+                    auto const sweepStart = Clock::now();
+                    std::size_t polled{};
+                    for(std::uint32_t channel{}; channel < numChannels_; ++channel) {
+                        sweepBytes[channel] = poll(jlink, *stage.rings[channel], channel);
+                        polled += sweepBytes[channel];
                     }
+                    counters.polledBytes.fetch_add(polled, std::memory_order_relaxed);
+                    stage.wake();
+                    if(capture.isOpen() && sweepStart - lastCaptureFlush >= CaptureFlushInterval) {
+                        capture.flush();
+                        lastCaptureFlush = sweepStart;
+                    }
+
                     jlink.checkConnected();
-                    if(jlink.isHalted()) { lastHaltDetected = Clock::now(); }
+                    if(jlink.isHalted()) {
+                        stage.lastHaltDetected.store(Clock::now(), std::memory_order_relaxed);
+                    }
                     JLink::Status const local_status = jlink.readStatus();
                     status                           = local_status;
                     if(local_status.isRunning == 0
@@ -165,7 +326,24 @@ private:
                     {
                         throw std::runtime_error("lost connection");
                     }
-                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                    counters.pollBusyNs.fetch_add(toNs(Clock::now() - sweepStart),
+                                                  std::memory_order_relaxed);
+                    updatePipelineRates(rateWindow);
+
+                    if(hasPollConfigChange.exchange(false, std::memory_order_acquire)) {
+                        scheduler.setConfig(getPollConfig());
+                    }
+                    auto const interval = scheduler.update(sweepBytes,
+                                                           local_status.numBytesRead,
+                                                           local_status.hostOverflowCount);
+                    counters.pollIntervalUs.store(
+                      static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(interval).count()),
+                      std::memory_order_relaxed);
+                    counters.overflowsPerSecond.store(scheduler.overflowRate(),
+                                                      std::memory_order_relaxed);
+
+                    std::this_thread::sleep_until(sweepStart + interval);
                     if(targetContinueFlag) {
                         targetContinueFlag = false;
                         jlink.go();
@@ -182,6 +360,7 @@ private:
                         jlink.setResetType(pendingResetType.load(std::memory_order_relaxed));
                     }
                 }
+                if(stage.failed) { throw std::runtime_error("parser failed"); }
             } catch(std::exception const& e) {
                 toolErrorMessageCallback(fmt::format("caught {}", e.what()));
                 std::this_thread::sleep_for(std::chrono::milliseconds{1000});
@@ -214,9 +393,18 @@ private:
     std::atomic<bool>          flashFlag;
     std::atomic<std::uint8_t>  pendingResetType;
     std::atomic<bool>          hasResetTypeChange;
-    std::mutex                 hostMutex;
-    std::optional<std::string> pendingHost;
-    std::jthread               thread;
+    std::atomic<std::size_t>   parserThreadCount{1};
+    PipelineCounters           counters;
+
+    uc_log::detail::rttraw::Writer capture;
+    std::mutex                     hostMutex;
+    std::optional<std::string>     pendingHost;
+    std::mutex                     captureMutex;
+    std::optional<std::string>     pendingCapturePath;
+    std::mutex                     pollConfigMutex;
+    PollConfig                     pollConfig;
+    std::atomic<bool>              hasPollConfigChange;
+    std::jthread                   thread;
 
 public:
     template<typename BlockInfoF,
@@ -230,6 +418,7 @@ public:
     JLinkRttReader(std::string         host_,
                    std::string         device_,
                    std::uint32_t       speed_,
+                   std::string         rawCaptureFile_,
                    BlockInfoF&&        blockInfof,
                    HexFileNameF&&      hexFileNamef,
                    CatalogMapF&&       catalogMapf,
@@ -249,6 +438,7 @@ public:
       , errorMessageCallback{std::forward<ErrorMessageF>(errorMessagef)}
       , toolMessageCallback{std::forward<ToolMessageF>(toolMessagef)}
       , toolErrorMessageCallback{std::forward<ToolErrorMessageF>(toolErrorMessagef)}
+      , pendingCapturePath{std::move(rawCaptureFile_)}
       , thread{[this](std::stop_token stoken) { run(std::move(stoken)); }} {}
 
     JLink::Status getStatus() const { return status; }
@@ -286,4 +476,51 @@ public:
     bool isFlashing() const { return flashFlag; }
 
     void setNoLogTimeout(std::uint32_t seconds) { noLogTimeoutSeconds_ = seconds; }
+
+    /// Number of parser threads used from the next (re)connect on, capped at the channel count.
+    void setParserThreadCount(std::size_t count) {
+        parserThreadCount = std::max<std::size_t>(count, 1);
+    }
+
+    /// Records every rttRead chunk to `path` (.rttraw) from the next (re)connect on, an empty path
+    /// stops recording. The capture of the first session is passed to the constructor instead.
+    void setRawCaptureFile(std::string path) {
+        {
+            std::lock_guard<std::mutex> lock{captureMutex};
+            pendingCapturePath = std::move(path);
+        }
+        jlinkResetFlag = true;
+    }
+
+    void setPollConfig(PollConfig const& config) {
+        {
+            std::lock_guard<std::mutex> lock{pollConfigMutex};
+            pollConfig = config;
+        }
+        hasPollConfigChange.store(true, std::memory_order_release);
+    }
+
+    PollConfig getPollConfig() {
+        std::lock_guard<std::mutex> lock{pollConfigMutex};
+        return pollConfig;
+    }
+
+    RttPipelineStats getPipelineStats() const {
+        return RttPipelineStats{
+          .polledBytes             = counters.polledBytes.load(std::memory_order_relaxed),
+          .parsedBytes             = counters.parsedBytes.load(std::memory_order_relaxed),
+          .parsedMessages          = counters.parsedMessages.load(std::memory_order_relaxed),
+          .ringFullEvents          = counters.ringFullEvents.load(std::memory_order_relaxed),
+          .ringCapacity            = RttRingSize,
+          .maxRingFill             = counters.maxRingFill.load(std::memory_order_relaxed),
+          .parserThreads           = counters.parserThreads.load(std::memory_order_relaxed),
+          .polledBytesPerSecond    = counters.polledBytesPerSecond.load(std::memory_order_relaxed),
+          .parsedMessagesPerSecond
+          = counters.parsedMessagesPerSecond.load(std::memory_order_relaxed),
+          .pollLoad                = counters.pollLoad.load(std::memory_order_relaxed),
+          .parseLoad               = counters.parseLoad.load(std::memory_order_relaxed),
+          .pollInterval
+          = std::chrono::microseconds{counters.pollIntervalUs.load(std::memory_order_relaxed)},
+          .overflowsPerSecond = counters.overflowsPerSecond.load(std::memory_order_relaxed)};
+    }
 };
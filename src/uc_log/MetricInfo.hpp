@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+namespace uc_log {
+struct MetricInfo {
+    std::string scope;
+    std::string name;
+    std::string unit;
+
+    auto operator<=>(MetricInfo const&) const = default;
+};
+}   // namespace uc_log
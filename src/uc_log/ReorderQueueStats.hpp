@@ -0,0 +1,13 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+struct ReorderQueueStats {
+    std::chrono::microseconds window{};         // hold time before an entry is handed out
+    std::chrono::microseconds skew{};           // decaying worst-case lateness between sources
+    std::uint64_t             lateArrivals{};   // entries that arrived after a later one left
+    std::size_t               pending{};
+    std::size_t               sources{};
+};
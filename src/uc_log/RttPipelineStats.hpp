@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+struct RttPipelineStats {
+    std::uint64_t             polledBytes{};
+    std::uint64_t             parsedBytes{};
+    std::uint64_t             parsedMessages{};
+    std::uint64_t             ringFullEvents{};
+    std::size_t               ringCapacity{};
+    std::size_t               maxRingFill{};
+    std::size_t               parserThreads{};
+    double                    polledBytesPerSecond{};
+    double                    parsedMessagesPerSecond{};
+    double                    pollLoad{};    // share of wall time spent talking to the probe
+    double                    parseLoad{};   // share of parser thread time spent parsing
+    std::chrono::microseconds pollInterval{};
+    double                    overflowsPerSecond{};
+};
@@ -0,0 +1,216 @@
+#pragma once
+#include "jlink/JLink.hpp"
+#include "uc_log/RttPipelineStats.hpp"
+#include "uc_log/detail/RttChannelParser.hpp"
+#include "uc_log/detail/RttRawFormat.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// Plays a .rttraw capture back through the normal parse path.
+///
+/// Provides the same interface as JLinkRttReader so it can drive Gui::run. `speed` scales the
+/// recorded timing (1 = real time, N = N times faster), 0 replays as fast as possible. Halt and
+/// continue pause the replay, resetting the target or the debugger starts it over.
+struct RttReplayReader {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run(std::stop_token stoken) {
+        while(!stoken.stop_requested()) {
+            restartFlag  = false;
+            finishedFlag = false;
+            toolMessageCallback(fmt::format("start replay of {:?}", path));
+            replay(stoken);
+            setStatus(0, 0);
+            finishedFlag = true;
+            toolMessageCallback("replay finished");
+            while(!stoken.stop_requested() && !restartFlag) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            }
+        }
+    }
+
+    void replay(std::stop_token const& stoken) {
+        uc_log::detail::rttraw::FileReader file;
+        if(auto const error = file.open(path)) {
+            toolErrorMessageCallback(*error);
+            return;
+        }
+
+        auto const stringConstantsMap = catalogMapCallback();
+        auto const hash               = uc_log::detail::rttraw::catalogHash(stringConstantsMap);
+
+        std::vector<uc_log::detail::RttChannelParser> parsers;
+        auto                                          start = Clock::now();
+        while(!stoken.stop_requested() && !restartFlag) {
+            auto record = file.next();
+            if(!record) { return; }
+
+            if(record->type == uc_log::detail::rttraw::RecordType::Session) {
+                if(record->catalogHash != hash) {
+                    toolErrorMessageCallback(
+                      "capture was made with a different string constants catalog");
+                }
+                parsers.clear();
+                parsers.resize(record->numChannels);
+                setStatus(1, record->numChannels);
+                continue;
+            }
+            if(record->channel >= parsers.size()) {
+                toolErrorMessageCallback(
+                  fmt::format("chunk for unknown channel {} skipped", record->channel));
+                continue;
+            }
+
+            auto const pauseStart = Clock::now();
+            while(pausedFlag && !stoken.stop_requested() && !restartFlag) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            }
+            start += Clock::now() - pauseStart;
+
+            auto const replaySpeed = speed.load(std::memory_order_relaxed);
+            if(replaySpeed > 0.0) {
+                std::this_thread::sleep_until(
+                  start
+                  + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::nano>(
+                      static_cast<double>(record->time.count()) / replaySpeed)));
+            }
+
+            auto const parseStart = Clock::now();
+            auto&      parser     = parsers[record->channel];
+            parser.append(record->bytes);
+            auto const messages = parser.parse(stoken,
+                                               record->channel,
+                                               stringConstantsMap,
+                                               entryPrintCallback,
+                                               errorMessageCallback);
+            countChunk(record->bytes.size(), messages, Clock::now() - parseStart);
+        }
+    }
+
+    void setStatus(int           isRunning,
+                   std::uint32_t numUpBuffers) {
+        std::lock_guard<std::mutex> lock{statusMutex};
+        status.isRunning    = isRunning;
+        status.numUpBuffers = static_cast<int>(numUpBuffers);
+    }
+
+    void countChunk(std::size_t     bytes,
+                    std::size_t     messages,
+                    Clock::duration busy) {
+        std::lock_guard<std::mutex> lock{statusMutex};
+        status.numBytesRead += static_cast<std::uint32_t>(bytes);
+        stats.polledBytes += bytes;
+        stats.parsedBytes += bytes;
+        stats.parsedMessages += messages;
+        parseBusy += busy;
+
+        auto const now     = Clock::now();
+        auto const elapsed = std::chrono::duration<double>(now - rateStart).count();
+        if(elapsed >= 1.0) {
+            stats.polledBytesPerSecond
+              = static_cast<double>(stats.polledBytes - rateBytes) / elapsed;
+            stats.parsedMessagesPerSecond
+              = static_cast<double>(stats.parsedMessages - rateMessages) / elapsed;
+            stats.parseLoad = std::chrono::duration<double>(parseBusy).count() / elapsed;
+            rateStart       = now;
+            rateBytes       = stats.polledBytes;
+            rateMessages    = stats.parsedMessages;
+            parseBusy       = {};
+        }
+    }
+
+    std::string         path;
+    std::atomic<double> speed;
+
+    std::function<std::unordered_map<std::uint16_t, std::string>(void)> catalogMapCallback;
+    std::function<void(std::size_t, std::string_view)>                  entryPrintCallback;
+    std::function<void(std::string_view)>                               messageCallback;
+    std::function<void(std::string_view)>                               errorMessageCallback;
+    std::function<void(std::string_view)>                               toolMessageCallback;
+    std::function<void(std::string_view)>                               toolErrorMessageCallback;
+
+    mutable std::mutex statusMutex;
+    JLink::Status      status{};
+    RttPipelineStats   stats{.parserThreads = 1};
+    Clock::time_point  rateStart{Clock::now()};
+    std::uint64_t      rateBytes{};
+    std::uint64_t      rateMessages{};
+    Clock::duration    parseBusy{};
+
+    std::atomic<bool> restartFlag;
+    std::atomic<bool> pausedFlag;
+    std::atomic<bool> finishedFlag;
+    std::jthread      thread;
+
+public:
+    template<typename CatalogMapF,
+             typename EntryPrintF,
+             typename MessageF,
+             typename ErrorMessageF,
+             typename ToolMessageF,
+             typename ToolErrorMessageF>
+    RttReplayReader(std::string         path_,
+                    double              speed_,
+                    CatalogMapF&&       catalogMapf,
+                    EntryPrintF&&       entryPrintf,
+                    MessageF&&          messagef,
+                    ErrorMessageF&&     errorMessagef,
+                    ToolMessageF&&      toolMessagef,
+                    ToolErrorMessageF&& toolErrorMessagef)
+      : path{std::move(path_)}
+      , speed{speed_}
+      , catalogMapCallback{std::forward<CatalogMapF>(catalogMapf)}
+      , entryPrintCallback{std::forward<EntryPrintF>(entryPrintf)}
+      , messageCallback{std::forward<MessageF>(messagef)}
+      , errorMessageCallback{std::forward<ErrorMessageF>(errorMessagef)}
+      , toolMessageCallback{std::forward<ToolMessageF>(toolMessagef)}
+      , toolErrorMessageCallback{std::forward<ToolErrorMessageF>(toolErrorMessagef)}
+      , thread{[this](std::stop_token stoken) { run(std::move(stoken)); }} {}
+
+    JLink::Status getStatus() const {
+        std::lock_guard<std::mutex> lock{statusMutex};
+        return status;
+    }
+
+    RttPipelineStats getPipelineStats() const {
+        std::lock_guard<std::mutex> lock{statusMutex};
+        return stats;
+    }
+
+    void resetJLink() { restartFlag = true; }
+
+    void setHost(std::string const&) {}
+
+    void resetTarget() { restartFlag = true; }
+
+    void haltTarget() { pausedFlag = true; }
+
+    void continueTarget() { pausedFlag = false; }
+
+    void clearAllBreakpointsTarget() {}
+
+    void setResetType(std::uint8_t) {}
+
+    void flash() { toolErrorMessageCallback("flashing is not available during replay"); }
+
+    bool isFlashing() const { return false; }
+
+    void setNoLogTimeout(std::uint32_t) {}
+
+    void setSpeed(double newSpeed) { speed = newSpeed; }
+
+    bool finished() const { return finishedFlag; }
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class OverflowPolicy : std::uint8_t {
+    Block,        // producer waits for room, nothing is lost
+    DropOldest,   // the oldest queued entry makes room for the new one
+    Sample        // only every SampleEvery-th entry is kept while the queue is full
+};
+
+struct SinkStats {
+    std::string    name;
+    OverflowPolicy policy{};
+    std::size_t    depth{};
+    std::size_t    maxDepth{};
+    std::size_t    capacity{};
+    std::uint64_t  delivered{};
+    std::uint64_t  dropped{};
+};
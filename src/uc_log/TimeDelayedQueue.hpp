@@ -1,57 +1,246 @@
 #pragma once
 
+#include "uc_log/ReorderQueueStats.hpp"
+#include "uc_log/detail/TimedEntry.hpp"
+
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <concepts>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <ranges>
-#include <set>
+#include <span>
+#include <stop_token>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/// Hands entries to `f` in projection order once they are older than the reorder window.
+///
+/// Every source (RTT channel) delivers its entries already in order, so each source keeps an
+/// ordered run and the queue only k-way merges the run heads through a min-heap. An entry that
+/// goes backwards within its source (target reset) starts a new run for that source. When the
+/// oldest pending entry is due, every head that sorts before it is emitted first.
+///
+/// The reorder window adapts to the measured skew between sources: every arrival is checked
+/// against the pending runs of the other sources and the recently emitted entries, the time the
+/// earliest later-sorting entry has already been waiting is how long this one would have had to
+/// be held. The window follows the decaying maximum of that, so a single source runs with close
+/// to no delay while e.g. ISR and thread channels get exactly the hold they need.
+///
+/// `f` is either called once per entry with (recv_time, entry) or, if it accepts a
+/// std::span<TimedEntry<Entry> const>, once per batch of entries that became ready together.
+/// flush() hands out everything pending right away, the destructor does so as well, so no entry
+/// appended before the queue goes away is lost.
 template<typename Entry, typename Projection, typename Function>
 struct TimeDelayedQueue {
 private:
     using Clock = std::chrono::steady_clock;
 
+    static constexpr std::chrono::milliseconds MinWindow{1};
+    static constexpr std::chrono::milliseconds MaxWindow{1000};
+    static constexpr std::chrono::milliseconds InitialSkew{200};
+    static constexpr std::chrono::seconds      SkewHalfLife{2};
+    static constexpr double                    SkewMargin{1.25};
+
     struct QEntry {
         Clock::time_point                     entryTime;
         std::chrono::system_clock::time_point sys_entryTime;
         Entry                                 entry;
     };
 
-    std::vector<QEntry>              q{};
+    struct Run {
+        std::size_t        source;
+        std::deque<QEntry> entries;
+    };
+
+    using Key = std::remove_cvref_t<std::invoke_result_t<Projection const&, QEntry const&>>;
+
+    struct Emitted {
+        Key               key;
+        Clock::time_point entryTime;
+    };
+
+    std::vector<std::unique_ptr<Run>> runs{};
+    std::vector<Run*>                 currentRun{};     // indexed by source
+    std::vector<std::optional<Key>>   lastKey{};        // newest key per source, drained or not
+    std::vector<Run*>                 heap{};           // non-empty runs, min head on top
+    std::deque<Emitted>               emitted{};        // handed out during the last MaxWindow
+    std::deque<std::uint64_t>         emittedMax{};     // positions of the falling key maxima
+    std::uint64_t                     emittedFront{};   // position of emitted.front()
+    std::size_t                       pending{};
+    bool                              draining{};   // flush() waits for everything pending
+    bool                              handing{};    // f is called with entries outside the lock
+
+    Clock::duration   skew{InitialSkew};
+    Clock::duration   window{windowFor(InitialSkew)};
+    Clock::time_point skewUpdate{Clock::now()};
+    Clock::time_point resumeSampling{};
+    std::uint64_t     lateArrivals{};
+
     [[no_unique_address]] Projection proj;
     [[no_unique_address]] Function   f;
 
-    std::condition_variable cv;
-    std::mutex              m;
-    std::jthread            thread{std::bind_front(&TimeDelayedQueue::run, this)};
+    std::condition_variable_any cv;
+    std::mutex                  m;
+    std::jthread                thread{std::bind_front(&TimeDelayedQueue::run, this)};
+
+    static Clock::duration windowFor(Clock::duration skewEstimate) {
+        return std::clamp(
+          std::chrono::duration_cast<Clock::duration>(skewEstimate * SkewMargin) + MinWindow,
+          Clock::duration{MinWindow},
+          Clock::duration{MaxWindow});
+    }
+
+    // how long the entry arriving now would have had to be held to come out in order
+    Clock::duration measureLateness(std::size_t       source,
+                                    Key const&        key,
+                                    Clock::time_point now) {
+        auto const keyLess = [this](Key const& k, QEntry const& e) {
+            return k < std::invoke(proj, e);
+        };
+
+        Clock::duration lateness{};
+        for(Run const* r : heap) {
+            if(r->source == source) { continue; }
+            auto const it = std::upper_bound(r->entries.begin(), r->entries.end(), key, keyLess);
+            if(it != r->entries.end()) { lateness = std::max(lateness, now - it->entryTime); }
+        }
+
+        // emitted is in hand out order, which is not key order whenever this branch is taken
+        if(!emittedMax.empty() && key < emitted[emittedMax.front() - emittedFront].key) {
+            ++lateArrivals;
+            for(auto const& e : emitted) {
+                if(key < e.key) { lateness = std::max(lateness, now - e.entryTime); }
+            }
+        }
+        return lateness;
+    }
+
+    void recordEmitted(QEntry const& qEntry) {
+        Emitted e{std::invoke(proj, qEntry), qEntry.entryTime};
+        while(!emittedMax.empty() && !(e.key < emitted[emittedMax.back() - emittedFront].key)) {
+            emittedMax.pop_back();
+        }
+        emittedMax.push_back(emittedFront + emitted.size());
+        emitted.push_back(std::move(e));
+    }
+
+    void forgetEmitted(Clock::time_point before) {
+        while(!emitted.empty() && emitted.front().entryTime < before) {
+            if(!emittedMax.empty() && emittedMax.front() == emittedFront) {
+                emittedMax.pop_front();
+            }
+            emitted.pop_front();
+            ++emittedFront;
+        }
+    }
+
+    void clearEmitted() {
+        emittedFront += emitted.size();
+        emitted.clear();
+        emittedMax.clear();
+    }
+
+    void updateWindow(Clock::duration   lateness,
+                      Clock::time_point now) {
+        auto const decay = std::exp2(-std::chrono::duration<double>(now - skewUpdate)
+                                     / std::chrono::duration<double>(SkewHalfLife));
+        skew = std::max(lateness, std::chrono::duration_cast<Clock::duration>(skew * decay));
+        skewUpdate = now;
+        window     = windowFor(skew);
+    }
+
+    bool headGreater(Run const* a,
+                     Run const* b) const {
+        return std::invoke(proj, b->entries.front()) < std::invoke(proj, a->entries.front());
+    }
+
+    auto heapCompare() const {
+        return [this](Run const* a, Run const* b) { return headGreater(a, b); };
+    }
+
+    std::optional<Clock::time_point> oldestEntryTime() const {
+        if(heap.empty()) { return std::nullopt; }
+        return std::ranges::min(heap | std::views::transform([](Run const* r) {
+                                    return r->entries.front().entryTime;
+                                }));
+    }
+
+    void retire(Run* r) {
+        if(currentRun[r->source] == r) { return; }
+        std::erase_if(runs, [r](auto const& owned) { return owned.get() == r; });
+    }
+
+    void popDue(Clock::time_point const                     deadline,
+                std::vector<uc_log::detail::TimedEntry<Entry>>& toHandle) {
+        while(!heap.empty()) {
+            if(heap.front()->entries.front().entryTime > deadline) {
+                auto const oldest = oldestEntryTime();
+                if(!oldest || *oldest > deadline) { return; }
+            }
+            std::ranges::pop_heap(heap, heapCompare());
+            auto* const r = heap.back();
+            if(r->entries.front().entryTime >= resumeSampling) {
+                // keys from before a reset say nothing about the ones after it
+                recordEmitted(r->entries.front());
+            }
+            toHandle.push_back(uc_log::detail::TimedEntry<Entry>{
+              r->entries.front().sys_entryTime, std::move(r->entries.front().entry)});
+            r->entries.pop_front();
+            --pending;
+            if(r->entries.empty()) {
+                heap.pop_back();
+                retire(r);
+            } else {
+                std::ranges::push_heap(heap, heapCompare());
+            }
+        }
+    }
 
     void run(std::stop_token const& stoken) {
-        std::vector<QEntry> toHandle{};
+        std::vector<uc_log::detail::TimedEntry<Entry>> toHandle{};
         while(!stoken.stop_requested()) {
             {
                 std::unique_lock<std::mutex> lock{m};
-                cv.wait_for(lock, std::chrono::milliseconds{50});
-                std::ranges::sort(q, std::ranges::less{}, proj);
-                auto const deadline = Clock::now() - std::chrono::milliseconds{200};
-                auto const pos      = std::ranges::partition_point(
-                  q,
-                  [&](auto const& entryTime) { return entryTime >= deadline; },
-                  [](auto const& entry) { return entry.entryTime; });
-                toHandle.reserve(static_cast<std::size_t>(std::distance(pos, q.end())));
-                toHandle.assign(std::make_move_iterator(pos), std::make_move_iterator(q.end()));
-
-                q.erase(pos, q.end());
+                auto const                   oldest = oldestEntryTime();
+                if(oldest) {
+                    cv.wait_until(lock, stoken, *oldest + window, [this] { return draining; });
+                } else {
+                    cv.wait(lock, stoken, [this] { return !heap.empty(); });
+                }
+                auto const now = Clock::now();
+                popDue(draining ? Clock::time_point::max() : now - window, toHandle);
+                forgetEmitted(now - MaxWindow);
+                handing = !toHandle.empty();
             }
 
-            for(auto const& entry : toHandle) {
-                f(entry.sys_entryTime, entry.entry);
-                if(stoken.stop_requested()) { return; }
+            if constexpr(std::is_invocable_v<Function&,
+                                             std::span<uc_log::detail::TimedEntry<Entry> const>>)
+            {
+                if(!toHandle.empty()) {
+                    f(std::span<uc_log::detail::TimedEntry<Entry> const>{toHandle});
+                }
+            } else {
+                for(auto const& entry : toHandle) {
+                    f(entry.recv_time, entry.entry);
+                    if(stoken.stop_requested()) { return; }
+                }
             }
             toHandle.clear();
+            {
+                std::lock_guard<std::mutex> const lock{m};
+                handing = false;
+            }
+            cv.notify_all();
         }
     }
 
@@ -61,13 +250,79 @@ public:
       : proj{std::move(projection)}
       , f{std::move(func)} {}
 
+    TimeDelayedQueue(TimeDelayedQueue const&)            = delete;
+    TimeDelayedQueue& operator=(TimeDelayedQueue const&) = delete;
+
+    ~TimeDelayedQueue() { flush(); }
+
     template<typename E>
-    void append(E&& entry) {
+    void append(std::size_t source,
+                E&&         entry) {
+        bool wasEmpty{};
         {
             std::lock_guard<std::mutex> const lock{m};
-            q.emplace_back(Clock::now(), std::chrono::system_clock::now(), std::forward<E>(entry));
+            wasEmpty = heap.empty();
+            if(source >= currentRun.size()) {
+                currentRun.resize(source + 1);
+                lastKey.resize(source + 1);
+            }
+
+            QEntry qEntry{Clock::now(), std::chrono::system_clock::now(), std::forward<E>(entry)};
+            auto const key  = std::invoke(proj, qEntry);
+            auto*&     r    = currentRun[source];
+            auto&      last = lastKey[source];
+            if(last && key < *last) {
+                // the previous run stays in the heap until it is drained, a drained one is
+                // reused; a reset is no skew, so sampling pauses until everything from before
+                // it has been handed out
+                if(r != nullptr && !r->entries.empty()) { r = nullptr; }
+                resumeSampling = qEntry.entryTime + window;
+                clearEmitted();
+            }
+            last = key;
+            updateWindow(qEntry.entryTime >= resumeSampling
+                           ? measureLateness(source, key, qEntry.entryTime)
+                           : Clock::duration{},
+                         qEntry.entryTime);
+            if(r == nullptr) {
+                runs.push_back(std::make_unique<Run>(source, std::deque<QEntry>{}));
+                r = runs.back().get();
+            }
+
+            r->entries.push_back(std::move(qEntry));
+            ++pending;
+            if(r->entries.size() == 1) {
+                heap.push_back(r);
+                std::ranges::push_heap(heap, heapCompare());
+            }
         }
-        cv.notify_one();
+        if(wasEmpty) { cv.notify_one(); }
+    }
+
+    template<typename E>
+    void append(E&& entry) {
+        append(0, std::forward<E>(entry));
+    }
+
+    /// Hands out every pending entry without waiting for the reorder window and returns once
+    /// `f` got all of them, e.g. at the end of a replay or on shutdown.
+    void flush() {
+        std::unique_lock<std::mutex> lock{m};
+        draining = true;
+        cv.notify_all();
+        cv.wait(lock, [this] { return pending == 0 && !handing; });
+        draining = false;
+    }
+
+    ReorderQueueStats getStats() {
+        std::lock_guard<std::mutex> const lock{m};
+        return ReorderQueueStats{
+          .window       = std::chrono::duration_cast<std::chrono::microseconds>(window),
+          .skew         = std::chrono::duration_cast<std::chrono::microseconds>(skew),
+          .lateArrivals = lateArrivals,
+          .pending      = pending,
+          .sources      = static_cast<std::size_t>(
+            std::ranges::count_if(currentRun, [](Run const* r) { return r != nullptr; }))};
     }
 };
 
@@ -76,6 +331,21 @@ namespace detail {
 template<typename F>
 struct function_traits;
 
+// batch callbacks take std::span<TimedEntry<Entry> const>
+template<typename R, typename T1>
+struct function_traits<R(T1)> {
+    using entry_type = typename std::remove_cvref_t<T1>::value_type::entry_type;
+};
+
+template<typename R, typename T1>
+struct function_traits<R (*)(T1)> : function_traits<R(T1)> {};
+
+template<typename C, typename R, typename T1>
+struct function_traits<R (C::*)(T1) const> : function_traits<R(T1)> {};
+
+template<typename C, typename R, typename T1>
+struct function_traits<R (C::*)(T1)> : function_traits<R(T1)> {};
+
 template<typename R, typename T1, typename T2>
 struct function_traits<R(T1, T2)> {
     using entry_type = std::remove_cvref_t<T2>;
@@ -103,7 +373,7 @@ template<typename F>
 using entry_type_t = typename function_traits<F>::entry_type;
 }   // namespace detail
 
-// Deduction guide: deduce Entry from Function's second parameter type
+// Deduction guide: deduce Entry from Function's second parameter type or its batch span
 template<typename P,
          typename F>
 TimeDelayedQueue(P&&,
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "uc_log/detail/LogEntry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+
+namespace uc_log::detail {
+
+/// Boots of the target in a LogStore, kept up to date at ingest.
+///
+/// A boot starts whenever the uC time jumps back by more than ResetThreshold, smaller jumps are
+/// late lines of the same boot. Boots are numbered from 1 for the whole session, so a number keeps
+/// naming the same boot while older ones are evicted, and looking one up by number is O(1). The
+/// time range of a boot also covers lines of it that were evicted already.
+class BootIndex {
+public:
+    static constexpr auto ResetThreshold = std::chrono::seconds{1};
+
+    struct Boot {
+        std::uint64_t            number;
+        std::uint64_t            beginSeq;
+        std::uint64_t            endSeq;
+        std::chrono::nanoseconds firstTime;
+        std::chrono::nanoseconds lastTime;
+        std::size_t              logCount{};
+    };
+
+private:
+    std::deque<Boot> bootList;
+    std::uint64_t    nextNumber{1};
+
+public:
+    std::deque<Boot> const& boots() const { return bootList; }
+
+    bool empty() const { return bootList.empty(); }
+
+    Boot const& latest() const { return bootList.back(); }
+
+    /// Adds a log of `lines` lines starting at `seq`. Returns true if it started a new boot after
+    /// an earlier one, i.e. a target reset was seen.
+    bool push_back(std::uint64_t    seq,
+                   std::size_t      lines,
+                   LogEntry::UcTime ucTime) {
+        bool const reset
+          = !bootList.empty() && ucTime.time + ResetThreshold < bootList.back().lastTime;
+        if(bootList.empty() || reset || bootList.back().endSeq != seq) {
+            bootList.push_back(Boot{.number    = nextNumber++,
+                                    .beginSeq  = seq,
+                                    .endSeq    = seq,
+                                    .firstTime = ucTime.time,
+                                    .lastTime  = ucTime.time});
+        }
+        auto& boot     = bootList.back();
+        boot.endSeq    = seq + lines;
+        boot.firstTime = std::min(boot.firstTime, ucTime.time);
+        boot.lastTime  = std::max(boot.lastTime, ucTime.time);
+        ++boot.logCount;
+        return reset;
+    }
+
+    /// Forgets the lines before `seq`, called before the store drops them. `startsLog(seq)` tells
+    /// for the lines of a partly dropped boot whether they counted as a log.
+    template<typename StartsLog>
+    void dropBefore(std::uint64_t seq,
+                    StartsLog&&   startsLog) {
+        while(!bootList.empty() && bootList.front().endSeq <= seq) { bootList.pop_front(); }
+        if(bootList.empty()) { return; }
+        auto& front = bootList.front();
+        for(; front.beginSeq < seq; ++front.beginSeq) {
+            if(startsLog(front.beginSeq)) { --front.logCount; }
+        }
+    }
+
+    /// Boot `number` if it is still stored.
+    Boot const* find(std::uint64_t number) const {
+        if(bootList.empty() || number < bootList.front().number || number > latest().number) {
+            return nullptr;
+        }
+        return &bootList[static_cast<std::size_t>(number - bootList.front().number)];
+    }
+
+    /// Lines belonging to boot `number`, the latest boot extends to every line still to come.
+    std::pair<std::uint64_t, std::uint64_t> seqRange(std::uint64_t number) const {
+        auto const* boot = find(number);
+        if(boot == nullptr) { return {0, 0}; }
+        if(boot != &latest()) { return {boot->beginSeq, boot->endSeq}; }
+        return {boot->beginSeq, std::numeric_limits<std::uint64_t>::max()};
+    }
+};
+
+}   // namespace uc_log::detail
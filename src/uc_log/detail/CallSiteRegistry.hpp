@@ -0,0 +1,92 @@
+#pragma once
+
+#include "uc_log/LogLevel.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace uc_log::detail {
+
+using CallSiteId = std::uint32_t;
+
+struct CallSiteInfo {
+    std::string      fileName;
+    std::size_t      line{};
+    uc_log::LogLevel logLevel{};
+    std::string      functionName;
+};
+
+/// Process wide, append only set of call sites (file, line, level, function).
+///
+/// Interning takes a lock, resolving an id does not: call sites live in fixed size chunks that
+/// never move once published. Ids only travel to other threads together with the entries
+/// that carry them, which already synchronizes the call site data. Id 0 is the empty call
+/// site used for messages without a context.
+class CallSiteRegistry {
+    static constexpr std::size_t ChunkBits = 10;
+    static constexpr std::size_t ChunkSize = std::size_t{1} << ChunkBits;
+    static constexpr std::size_t MaxChunks = 4096;
+
+    using Key = std::tuple<std::string_view, std::size_t, uc_log::LogLevel, std::string_view>;
+
+    std::array<std::atomic<CallSiteInfo*>, MaxChunks> chunks{};
+    std::vector<std::unique_ptr<CallSiteInfo[]>>      ownedChunks;
+    std::map<Key, CallSiteId>                         ids;
+    mutable std::mutex                                mutex;
+    CallSiteId                                        nextId{};
+
+    CallSiteRegistry() { intern({}, 0, uc_log::LogLevel{}, {}); }
+
+public:
+    static constexpr CallSiteId Unknown = 0;
+
+    CallSiteRegistry(CallSiteRegistry const&)            = delete;
+    CallSiteRegistry& operator=(CallSiteRegistry const&) = delete;
+
+    static CallSiteRegistry& instance() {
+        static CallSiteRegistry registry;
+        return registry;
+    }
+
+    CallSiteId intern(std::string_view fileName,
+                      std::size_t      line,
+                      uc_log::LogLevel logLevel,
+                      std::string_view functionName) {
+        std::lock_guard<std::mutex> const lock{mutex};
+        if(auto const it = ids.find(Key{fileName, line, logLevel, functionName}); it != ids.end()) {
+            return it->second;
+        }
+        if(nextId == MaxChunks * ChunkSize) { return Unknown; }
+
+        auto& chunk = chunks[nextId >> ChunkBits];
+        if(chunk.load(std::memory_order_relaxed) == nullptr) {
+            ownedChunks.push_back(std::make_unique<CallSiteInfo[]>(ChunkSize));
+            chunk.store(ownedChunks.back().get(), std::memory_order_release);
+        }
+        auto& info = chunk.load(std::memory_order_relaxed)[nextId & (ChunkSize - 1)];
+        info = CallSiteInfo{std::string{fileName}, line, logLevel, std::string{functionName}};
+        ids.emplace(Key{info.fileName, info.line, info.logLevel, info.functionName}, nextId);
+        return nextId++;
+    }
+
+    /// Number of interned call sites, every id below it can be resolved.
+    std::size_t size() const {
+        std::lock_guard<std::mutex> const lock{mutex};
+        return nextId;
+    }
+
+    CallSiteInfo const& operator[](CallSiteId id) const {
+        return chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (ChunkSize - 1)];
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "uc_log/LogLevel.hpp"
+#include "uc_log/detail/CallSiteRegistry.hpp"
+#include "uc_log/detail/LogEntry.hpp"
+#include "uc_log/detail/MetricRegistry.hpp"
+#include "uc_log/metric_utils.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace uc_log::detail {
+
+struct CallSite {
+    CallSiteId              id{};
+    std::string             suffix;   // `, """function""")` as it appears in the message
+    std::vector<MetricSlot> metrics;
+    bool                    textMetrics{};   // some metrics need the text search
+};
+
+/// Call sites of every UC_LOG statement in the string constants catalog.
+///
+/// Each catalog format string starts with the static context `("file", line, level, {},
+/// """function""")`. The table is built once per catalog and keyed by the formatted prefix up
+/// to the timestamp, so a message only needs a hash lookup, the timestamp and a suffix compare
+/// instead of re-parsing its context. The metrics of the format string are resolved here as
+/// well, so their values are parsed in their logged type without searching for markers.
+class CallSiteTable {
+    struct PrefixHash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view sv) const {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+    std::vector<CallSite>                                                                  sites;
+    std::unordered_map<std::string, std::vector<std::size_t>, PrefixHash, std::equal_to<>> byPrefix;
+
+    // `("file", line, level, ` including the trailing separator
+    static std::optional<std::size_t> prefixLength(std::string_view msg) {
+        if(!msg.starts_with("(\"")) { return std::nullopt; }
+        auto pos = msg.find("\", ", 2);
+        if(pos == std::string_view::npos) { return std::nullopt; }
+        pos += 3;
+        for(int field{}; field < 2; ++field) {
+            pos = msg.find(", ", pos);
+            if(pos == std::string_view::npos) { return std::nullopt; }
+            pos += 2;
+        }
+        return pos;
+    }
+
+    static std::string unescapeBraces(std::string_view escaped) {
+        std::string out;
+        out.reserve(escaped.size());
+        for(std::size_t i{}; i < escaped.size(); ++i) {
+            out.push_back(escaped[i]);
+            if((escaped[i] == '{' || escaped[i] == '}') && i + 1 < escaped.size()
+               && escaped[i + 1] == escaped[i])
+            {
+                ++i;
+            }
+        }
+        return out;
+    }
+
+    static std::optional<CallSite> parseCatalogEntry(std::string_view fmtString) {
+        auto const prefixLen = prefixLength(fmtString);
+        if(!prefixLen || !fmtString.substr(*prefixLen).starts_with(R"({}, """)")) {
+            return std::nullopt;
+        }
+        auto const functionStart = *prefixLen + std::string_view{R"({}, """)"}.size();
+        auto const functionEnd   = fmtString.find(R"(""")", functionStart);
+        if(functionEnd == std::string_view::npos) { return std::nullopt; }
+
+        auto       context = fmtString.substr(2, *prefixLen - 4);
+        auto const fileEnd = context.find("\", ");
+        auto const fileSv  = context.substr(0, fileEnd);
+        context.remove_prefix(fileEnd + 3);
+
+        auto const lineEnd = context.find(", ");
+        auto const lineSv  = context.substr(0, lineEnd);
+        auto const levelSv = context.substr(lineEnd + 2);
+
+        std::size_t line{};
+        {
+            auto const [ptr, ec] = std::from_chars(lineSv.begin(), lineSv.end(), line);
+            if(ec != std::errc{} || ptr != lineSv.end()) { return std::nullopt; }
+        }
+        std::uint8_t level{};
+        {
+            auto const [ptr, ec] = std::from_chars(levelSv.begin(), levelSv.end(), level);
+            if(ec != std::errc{} || ptr != levelSv.end()) { return std::nullopt; }
+        }
+
+        auto const functionName
+          = unescapeBraces(fmtString.substr(functionStart, functionEnd - functionStart));
+        auto const id = CallSiteRegistry::instance().intern(
+          fileSv, line, static_cast<uc_log::LogLevel>(level), functionName);
+        CallSite site{id, R"(, """)" + functionName + R"("""))", {}};
+        parseMetricSlots(site, fmtString.substr(functionEnd + 4), fileSv, line);
+        return site;
+    }
+
+    // `@METRIC(scope::name[unit]#t={})` as injected by metric.hpp, markers containing a
+    // replacement field are only known once formatted and left to the text search
+    static void parseMetricSlots(CallSite&        site,
+                                 std::string_view payload,
+                                 std::string_view fileName,
+                                 std::size_t      line) {
+        auto& slots = site.metrics;
+        for(auto pos = payload.find("@METRIC("); pos != std::string_view::npos;
+            pos      = payload.find("@METRIC(", pos))
+        {
+            auto const equals = payload.find('=', pos);
+            if(equals == std::string_view::npos) { break; }
+            auto const markerText = payload.substr(pos, equals + 1 - pos);
+            pos                   = equals + 1;
+            if(markerText.find_first_of("{}") != std::string_view::npos) {
+                site.textMetrics = true;
+                continue;
+            }
+
+            auto const marker = parseMetricMarker(markerText.substr(8, markerText.size() - 9));
+            if(!marker) { continue; }
+            auto const scope = marker->scope.empty() ? fmt::format("{}:{}", fileName, line)
+                                                     : std::string{marker->scope};
+            auto const id = MetricRegistry::instance().intern(scope, marker->name, marker->unit);
+            if(id == MetricRegistry::Invalid) { continue; }
+            slots.push_back(MetricSlot{std::string{markerText}, id, marker->type});
+        }
+    }
+
+public:
+    struct Match {
+        CallSite const*  site;
+        LogEntry::UcTime ucTime;
+        std::string_view payload;
+    };
+
+    CallSiteTable() = default;
+
+    explicit CallSiteTable(std::unordered_map<std::uint16_t, std::string> const& catalog) {
+        for(auto const& fmtString : catalog | std::views::values) {
+            auto site = parseCatalogEntry(fmtString);
+            if(!site) { continue; }
+            auto const prefixLen = *prefixLength(fmtString);
+            auto&      candidates
+              = byPrefix[std::string{std::string_view{fmtString}.substr(0, prefixLen)}];
+            // UC_LOGs sharing the line and function, e.g. in a template, share the entry.
+            // Their messages are told apart by the text search if their metrics differ.
+            auto const known = std::ranges::find_if(candidates, [&](std::size_t index) {
+                return sites[index].suffix == site->suffix;
+            });
+            if(known != candidates.end()) {
+                auto& shared = sites[*known];
+                if(shared.metrics != site->metrics || site->textMetrics) {
+                    shared.textMetrics = true;
+                }
+                continue;
+            }
+            candidates.push_back(sites.size());
+            sites.push_back(std::move(*site));
+        }
+    }
+
+    bool empty() const { return sites.empty(); }
+
+    std::size_t size() const { return sites.size(); }
+
+    std::optional<Match> match(std::string_view msg) const {
+        auto const prefixLen = prefixLength(msg);
+        if(!prefixLen) { return std::nullopt; }
+        auto const it = byPrefix.find(msg.substr(0, *prefixLen));
+        if(it == byPrefix.end()) { return std::nullopt; }
+
+        // timestamps never contain a comma, the suffix starts right behind them
+        auto const timeEnd = msg.find(',', *prefixLen);
+        if(timeEnd == std::string_view::npos) { return std::nullopt; }
+        auto const rest = msg.substr(timeEnd);
+
+        for(auto const index : it->second) {
+            auto const& site = sites[index];
+            if(!rest.starts_with(site.suffix)) { continue; }
+            auto const ucTime
+              = LogEntry::parseTimeString(msg.substr(*prefixLen, timeEnd - *prefixLen));
+            if(!ucTime) { return std::nullopt; }
+            return Match{&site, *ucTime, rest.substr(site.suffix.size())};
+        }
+        return std::nullopt;
+    }
+};
+
+/// Builds a LogEntry with its metrics through the call-site table, falling back to parsing
+/// the context and searching for metrics for messages that do not belong to a known call site.
+/// Metrics of a known call site are searched in the text as well if the site has metrics that
+/// were not resolved from the catalog or a marker of its slots is missing.
+inline LogEntry makeLogEntry(std::size_t          channel,
+                             std::string_view     msg,
+                             CallSiteTable const& callSites) {
+    auto const match = callSites.match(msg);
+    if(!match) {
+        LogEntry entry{channel, msg};
+        uc_log::extractMetrics(entry);
+        return entry;
+    }
+    LogEntry entry{LogEntry::Channel{channel},
+                   match->ucTime,
+                   match->site->id,
+                   MessageText{match->payload}};
+    auto const metrics = match->site->textMetrics
+                         ? std::nullopt
+                         : extractMetrics(match->payload, match->site->metrics);
+    if(metrics) {
+        entry.metrics = *metrics;
+    } else {
+        uc_log::extractMetrics(entry);
+    }
+    return entry;
+}
+}   // namespace uc_log::detail
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "uc_log/LogLevel.hpp"
+#include "uc_log/detail/CallSiteRegistry.hpp"
+#include "uc_log/detail/LogStore.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace uc_log::detail {
+
+/// Flat form of the GUI log filter, evaluated on the columns of a LogStore.
+///
+/// Levels and channels become lookup tables and the file/line include and exclude rules are
+/// resolved once per call site into a table indexed by call-site id, so testing a line is a few
+/// loads and ands without branches. Call sites interned after the filter was compiled are added
+/// by resolveCallSites().
+class CompiledFilter {
+public:
+    using LocationRule = std::function<bool(CallSiteInfo const&)>;
+
+private:
+    std::array<std::uint8_t, 256> levels{};
+    std::vector<std::uint8_t>     channels;
+    std::vector<std::uint8_t>     callSites;
+    LocationRule                  location;
+    std::chrono::nanoseconds      minUcTime{std::chrono::nanoseconds::min()};
+    std::chrono::nanoseconds      maxUcTime{std::chrono::nanoseconds::max()};
+    std::uint64_t                 beginSeq{};
+    std::uint64_t                 endSeq{std::numeric_limits<std::uint64_t>::max()};
+
+    static std::chrono::nanoseconds toUcTime(double seconds) {
+        auto const limit = std::chrono::duration<double>{std::chrono::nanoseconds::max()}.count();
+        if(seconds >= limit) { return std::chrono::nanoseconds::max(); }
+        if(seconds <= -limit) { return std::chrono::nanoseconds::min(); }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::duration<double>{seconds});
+    }
+
+    std::uint8_t callSitePasses(CallSiteId id) const {
+        if(id < callSites.size()) { return callSites[id]; }
+        return location(CallSiteRegistry::instance()[id]) ? 1 : 0;
+    }
+
+public:
+    /// Passes everything.
+    CompiledFilter()
+      : CompiledFilter{std::vector<uc_log::LogLevel>{}, std::vector<std::size_t>{}, {}} {}
+
+    /// An empty level or channel list lets every level or channel pass, an empty location rule
+    /// every call site.
+    template<typename Levels, typename Channels>
+    CompiledFilter(Levels const&   enabledLevels,
+                   Channels const& enabledChannels,
+                   LocationRule    locationRule)
+      : channels(std::size_t{1} << 16, std::uint8_t{1})
+      , location{std::move(locationRule)} {
+        if(std::ranges::empty(enabledLevels)) {
+            levels.fill(1);
+        } else {
+            for(auto const level : enabledLevels) { levels[static_cast<std::uint8_t>(level)] = 1; }
+        }
+        if(!std::ranges::empty(enabledChannels)) {
+            std::ranges::fill(channels, std::uint8_t{0});
+            for(auto const channel : enabledChannels) {
+                if(channel < channels.size()) { channels[channel] = 1; }
+            }
+        }
+        if(!location) { location = [](CallSiteInfo const&) { return true; }; }
+        resolveCallSites();
+    }
+
+    /// Only lets lines with a uC time in [minSeconds, maxSeconds] pass.
+    void setUcTimeRange(double minSeconds,
+                        double maxSeconds) {
+        minUcTime = toUcTime(minSeconds);
+        maxUcTime = toUcTime(maxSeconds);
+    }
+
+    std::chrono::nanoseconds minTime() const { return minUcTime; }
+
+    std::chrono::nanoseconds maxTime() const { return maxUcTime; }
+
+    /// Only lets the lines with a sequence number in [begin, end) pass.
+    void setSeqRange(std::uint64_t begin,
+                     std::uint64_t end) {
+        beginSeq = begin;
+        endSeq   = end;
+    }
+
+    std::pair<std::uint64_t, std::uint64_t> seqRange() const { return {beginSeq, endSeq}; }
+
+    /// Extends the call-site table to every call site interned so far.
+    void resolveCallSites() {
+        auto const& registry = CallSiteRegistry::instance();
+        auto const  count    = registry.size();
+        callSites.reserve(count);
+        for(auto id = static_cast<CallSiteId>(callSites.size()); id < count; ++id) {
+            callSites.push_back(location(registry[id]) ? 1 : 0);
+        }
+    }
+
+    /// Makes sure `id` is in the call-site table.
+    void resolve(CallSiteId id) {
+        if(id >= callSites.size()) { resolveCallSites(); }
+    }
+
+    bool passes(LogLine const& line) const {
+        return (levels[static_cast<std::uint8_t>(line.level)]
+                & channels[static_cast<std::uint16_t>(line.channel.channel)]
+                & callSitePasses(line.callSite)
+                & static_cast<std::uint8_t>(line.ucTime.time >= minUcTime)
+                & static_cast<std::uint8_t>(line.ucTime.time <= maxUcTime)
+                & static_cast<std::uint8_t>(line.seq >= beginSeq)
+                & static_cast<std::uint8_t>(line.seq < endSeq))
+            != 0;
+    }
+
+    /// Sets `out[i]` to 1 for every passing line of `columns` and to 0 for the others.
+    ///
+    /// Every call site in `columns` has to be resolved already, which holds for all lines that
+    /// were stored before the last resolveCallSites().
+    void evaluate(LogStore::Columns const&   columns,
+                  std::vector<std::uint8_t>& out) const {
+        out.resize(columns.size());
+        for(std::size_t i{}; i < columns.size(); ++i) {
+            auto const seq = columns.firstSeq + i;
+            out[i]         = static_cast<std::uint8_t>(
+              levels[static_cast<std::uint8_t>(columns.level[i])] & channels[columns.channel[i]]
+              & callSites[columns.callSite[i]]
+              & static_cast<std::uint8_t>(columns.ucTime[i].time >= minUcTime)
+              & static_cast<std::uint8_t>(columns.ucTime[i].time <= maxUcTime)
+              & static_cast<std::uint8_t>(seq >= beginSeq)
+              & static_cast<std::uint8_t>(seq < endSeq));
+        }
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "uc_log/detail/CompiledFilter.hpp"
+#include "uc_log/detail/FilteredIndex.hpp"
+#include "uc_log/detail/LogStore.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace uc_log::detail {
+
+/// Rebuilds a FilteredIndex over a LogStore snapshot on a pool of worker threads.
+///
+/// The chunks of the snapshot are handed out one at a time and each one produces its own
+/// partial index, the worker finishing the last chunk concatenates them and publishes the
+/// result through take(). Starting another rebuild or cancel() abandons the running one, its
+/// workers drop out after their current chunk.
+class FilterRebuilder {
+public:
+    struct Result {
+        std::uint64_t      generation{};
+        LogStore::Snapshot snapshot;   // the index resolves against snapshot.beginSeq()
+        FilteredIndex      index;
+        std::size_t        logCount{};   // lines in the index that start a log
+    };
+
+private:
+    struct Partial {
+        FilteredIndex index;
+        std::size_t   logCount{};
+    };
+
+    struct Job {
+        Job(std::uint64_t      generation_,
+            LogStore::Snapshot snapshot_,
+            CompiledFilter     filter_)
+          : generation{generation_}
+          , snapshot{std::move(snapshot_)}
+          , filter{std::move(filter_)}
+          , chunks{snapshot.chunkCount()}
+          , partials(chunks)
+          , remaining{chunks} {}
+
+        std::uint64_t            generation;
+        LogStore::Snapshot       snapshot;
+        CompiledFilter           filter;
+        std::size_t              chunks;
+        std::vector<Partial>     partials;
+        std::atomic<std::size_t> nextChunk{};
+        std::atomic<std::size_t> remaining;
+        std::atomic<bool>        cancelled{};
+    };
+
+    std::mutex                  mutex;
+    std::condition_variable_any wake;
+    std::shared_ptr<Job>        job;
+    std::optional<Result>       result;
+    std::function<void()>       onReady;
+    std::vector<std::jthread>   workers;
+
+    static void scan(Job&                       job,
+                     std::size_t                i,
+                     std::vector<std::uint8_t>& matches) {
+        auto const& columns = job.snapshot.chunk(i);
+        auto&       partial = job.partials[i];
+        job.filter.evaluate(columns, matches);
+        partial.index.append(columns.firstSeq, matches);
+        for(std::size_t line{}; line < columns.size(); ++line) {
+            partial.logCount
+              += matches[line] & static_cast<std::uint8_t>(startsLog(columns.lineType[line]));
+        }
+    }
+
+    void finish(Job& done) {
+        Result finished{done.generation, done.snapshot, {}, 0};
+        for(auto& partial : done.partials) {
+            if(done.cancelled) { return; }
+            finished.index.append(partial.index);
+            finished.logCount += partial.logCount;
+            partial = Partial{};
+        }
+        {
+            std::lock_guard<std::mutex> const lock{mutex};
+            if(done.cancelled) { return; }
+            result = std::move(finished);
+            job.reset();
+        }
+        onReady();
+    }
+
+    void work(std::stop_token const& stoken) {
+        std::vector<std::uint8_t> matches;
+        while(!stoken.stop_requested()) {
+            std::shared_ptr<Job> current;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                if(!wake.wait(lock, stoken, [&]() { return job && job->nextChunk < job->chunks; }))
+                {
+                    return;
+                }
+                current = job;
+            }
+            while(!current->cancelled && !stoken.stop_requested()) {
+                auto const i = current->nextChunk++;
+                if(i >= current->chunks) { break; }
+                scan(*current, i, matches);
+                if(--current->remaining == 0) { finish(*current); }
+            }
+        }
+    }
+
+    void abandon() {
+        if(job) { job->cancelled = true; }
+        job.reset();
+        result.reset();
+    }
+
+public:
+    template<typename ReadyF>
+    explicit FilterRebuilder(ReadyF&&    readyf,
+                             std::size_t threads = std::max(1U,
+                                                            std::thread::hardware_concurrency()))
+      : onReady{std::forward<ReadyF>(readyf)} {
+        for(std::size_t i{}; i < threads; ++i) {
+            workers.emplace_back([this](std::stop_token stoken) { work(stoken); });
+        }
+    }
+
+    /// Replaces any running rebuild. Once the result is there `onReady` is called from the worker
+    /// that finished it, without any lock held. An empty snapshot has its result right away.
+    void start(std::uint64_t      generation,
+               LogStore::Snapshot snapshot,
+               CompiledFilter     filter) {
+        auto next = std::make_shared<Job>(generation, std::move(snapshot), std::move(filter));
+        {
+            std::lock_guard<std::mutex> const lock{mutex};
+            abandon();
+            if(next->chunks != 0) {
+                job = std::move(next);
+            } else {
+                result = Result{generation, std::move(next->snapshot), {}, 0};
+            }
+        }
+        wake.notify_all();
+    }
+
+    void cancel() {
+        std::lock_guard<std::mutex> const lock{mutex};
+        abandon();
+    }
+
+    std::optional<Result> take() {
+        std::lock_guard<std::mutex> const lock{mutex};
+        return std::exchange(result, std::nullopt);
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace uc_log::detail {
+
+/// Lines of a LogStore passing a filter, in store order.
+///
+/// Only the low 32 bits of each sequence number are kept and resolved against a base, usually
+/// the store's beginSeq(). That is unambiguous as long as the store holds fewer than 2^32 lines,
+/// which its entry and byte budget ensure. Dropping from the front only advances an offset, the
+/// vector is compacted once most of it is dead.
+class FilteredIndex {
+    static constexpr std::size_t CompactThreshold = std::size_t{1} << 16;
+
+    std::vector<std::uint32_t> indices;
+    std::size_t                head{};
+
+    static std::uint64_t resolve(std::uint32_t index,
+                                 std::uint64_t base) {
+        return base + static_cast<std::uint32_t>(index - static_cast<std::uint32_t>(base));
+    }
+
+    void compact() {
+        if(head >= CompactThreshold && head * 2 >= indices.size()) {
+            indices.erase(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(head));
+            head = 0;
+        }
+    }
+
+public:
+    void push_back(std::uint64_t seq) { indices.push_back(static_cast<std::uint32_t>(seq)); }
+
+    std::size_t size() const { return indices.size() - head; }
+
+    bool empty() const { return size() == 0; }
+
+    /// Sequence number at position `pos`, `base` has to be at most the oldest one stored.
+    std::uint64_t seq(std::size_t   pos,
+                      std::uint64_t base) const {
+        return resolve(indices[head + pos], base);
+    }
+
+    /// First position holding `seq` or a later line, size() if there is none.
+    std::size_t position(std::uint64_t seq,
+                         std::uint64_t base) const {
+        auto const it = std::partition_point(
+          indices.begin() + static_cast<std::ptrdiff_t>(head),
+          indices.end(),
+          [&](std::uint32_t index) { return resolve(index, base) < seq; });
+        return static_cast<std::size_t>(it - indices.begin()) - head;
+    }
+
+    bool startsWith(std::uint64_t seq) const {
+        return !empty() && indices[head] == static_cast<std::uint32_t>(seq);
+    }
+
+    /// Appends `firstSeq + i` for every `i` with `matches[i] != 0`.
+    void append(std::uint64_t                 firstSeq,
+                std::span<std::uint8_t const> matches) {
+        auto kept = indices.size();
+        indices.resize(kept + matches.size());
+        for(std::size_t i{}; i < matches.size(); ++i) {
+            indices[kept] = static_cast<std::uint32_t>(firstSeq + i);
+            kept += matches[i] != 0 ? 1 : 0;
+        }
+        indices.resize(kept);
+    }
+
+    /// Appends all lines of `other`, which has to continue this index.
+    void append(FilteredIndex const& other) {
+        indices.insert(indices.end(),
+                       other.indices.begin() + static_cast<std::ptrdiff_t>(other.head),
+                       other.indices.end());
+    }
+
+    void pop_front() {
+        ++head;
+        compact();
+    }
+
+    /// Removes the lines in [first, last), calling `onErase(seq)` for each. Removing from the
+    /// front only advances the offset, otherwise the lines behind the range move.
+    template<typename OnErase>
+    void erase(std::uint64_t first,
+               std::uint64_t last,
+               std::uint64_t base,
+               OnErase&&     onErase) {
+        if(first >= last) { return; }
+        auto const from = position(first, base);
+        auto const to   = position(last, base);
+        for(auto pos = from; pos < to; ++pos) { onErase(seq(pos, base)); }
+        if(from == 0) {
+            head += to;
+            compact();
+            return;
+        }
+        indices.erase(indices.begin() + static_cast<std::ptrdiff_t>(head + from),
+                      indices.begin() + static_cast<std::ptrdiff_t>(head + to));
+    }
+
+    /// Inserts the lines of [first, last) that `add(seq)` returns true for, none of them may be
+    /// in the index yet. Only the lines behind the range move.
+    template<typename Add>
+    void insert(std::uint64_t first,
+                std::uint64_t last,
+                std::uint64_t base,
+                Add&&         add) {
+        if(first >= last) { return; }
+        std::vector<std::uint32_t> added;
+        for(auto seq = first; seq < last; ++seq) {
+            if(add(seq)) { added.push_back(static_cast<std::uint32_t>(seq)); }
+        }
+        auto const pos = head + position(first, base);
+        indices.insert(
+          indices.begin() + static_cast<std::ptrdiff_t>(pos), added.begin(), added.end());
+    }
+
+    void clear() {
+        indices.clear();
+        head = 0;
+    }
+
+    /// Keeps the lines `keep(seq)` returns true for, for a filter that got narrower.
+    template<typename Keep>
+    void retain(std::uint64_t base,
+                Keep&&        keep) {
+        std::size_t kept{};
+        for(std::size_t pos{head}; pos < indices.size(); ++pos) {
+            if(keep(resolve(indices[pos], base))) { indices[kept++] = indices[pos]; }
+        }
+        indices.resize(kept);
+        head = 0;
+    }
+
+    /// Adds the lines of [begin, end) that are not in the index yet and `add(seq)` returns true
+    /// for, for a filter that got wider. Lines already in the index are not tested again.
+    template<typename Add>
+    void merge(std::uint64_t begin,
+               std::uint64_t end,
+               Add&&         add) {
+        std::vector<std::uint32_t> merged;
+        merged.reserve(size());
+        std::size_t pos{head};
+        for(auto seq = begin; seq != end; ++seq) {
+            auto const index = static_cast<std::uint32_t>(seq);
+            if(pos != indices.size() && indices[pos] == index) {
+                merged.push_back(index);
+                ++pos;
+            } else if(add(seq)) {
+                merged.push_back(index);
+            }
+        }
+        indices = std::move(merged);
+        head    = 0;
+    }
+};
+
+}   // namespace uc_log::detail
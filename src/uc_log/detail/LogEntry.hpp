@@ -1,6 +1,8 @@
 #pragma once
 
 #include "uc_log/LogLevel.hpp"
+#include "uc_log/detail/CallSiteRegistry.hpp"
+#include "uc_log/detail/MetricRegistry.hpp"
 
 #include <algorithm>
 #include <array>
@@ -8,6 +10,7 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #ifdef __GNUC__
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Wsign-conversion"
@@ -47,6 +50,44 @@
 
 namespace uc_log { namespace detail {
 
+    /// Immutable message text shared between copies of an entry.
+    ///
+    /// Copying only bumps a reference count, and slice() hands out parts of the same buffer, e.g.
+    /// the single lines of a multi-line message.
+    class MessageText {
+        std::shared_ptr<char const[]> buffer;
+        std::uint32_t                 offset{};
+        std::uint32_t                 length{};
+
+    public:
+        MessageText() = default;
+
+        explicit MessageText(std::string_view text)
+          : length{static_cast<std::uint32_t>(text.size())} {
+            if(text.empty()) { return; }
+            auto storage = std::make_shared_for_overwrite<char[]>(text.size());
+            std::ranges::copy(text, storage.get());
+            buffer = std::move(storage);
+        }
+
+        std::string_view view() const {
+            if(!buffer) { return {}; }
+            return std::string_view{std::next(buffer.get(), offset), length};
+        }
+
+        operator std::string_view() const { return view(); }
+
+        /// `part` has to point into view().
+        MessageText slice(std::string_view part) const {
+            MessageText text{};
+            if(part.empty()) { return text; }
+            text.buffer = buffer;
+            text.offset = static_cast<std::uint32_t>(part.data() - buffer.get());
+            text.length = static_cast<std::uint32_t>(part.size());
+            return text;
+        }
+    };
+
     struct LogEntry {
         struct Channel {
             std::size_t channel;
@@ -68,13 +109,23 @@ namespace uc_log { namespace detail {
             constexpr auto operator<=>(UcTime const&) const = default;
         };
 
-        Channel          channel{};
-        UcTime           ucTime;
-        std::string      fileName;
-        std::size_t      line{};
-        uc_log::LogLevel logLevel{};
-        std::string      functionName;
-        std::string      logMsg;
+        Channel       channel{};
+        UcTime        ucTime;
+        MessageText   message;
+        CallSiteId    callSite{CallSiteRegistry::Unknown};
+        MetricSamples metrics;   // filled once when the entry is built, read by every sink
+
+        CallSiteInfo const& callSiteInfo() const { return CallSiteRegistry::instance()[callSite]; }
+
+        std::string_view fileName() const { return callSiteInfo().fileName; }
+
+        std::size_t line() const { return callSiteInfo().line; }
+
+        uc_log::LogLevel logLevel() const { return callSiteInfo().logLevel; }
+
+        std::string_view functionName() const { return callSiteInfo().functionName; }
+
+        std::string_view logMsg() const { return message.view(); }
 
         template<typename Ratio>
         static constexpr auto makeLookUp(std::string_view suffix,
@@ -173,15 +224,24 @@ namespace uc_log { namespace detail {
             return std::nullopt;
         }
 
+        LogEntry(Channel     channel_,
+                 UcTime      ucTime_,
+                 CallSiteId  callSite_,
+                 MessageText message_)
+          : channel{channel_}
+          , ucTime{ucTime_}
+          , message{std::move(message_)}
+          , callSite{callSite_} {}
+
         LogEntry(std::size_t      channel_,
                  std::string_view msg)
           : channel{channel_} {
             auto const pos = msg.find(R"("""))");
             if(pos == std::string_view::npos || !msg.starts_with("(")) {
-                logMsg = msg;
+                message = MessageText{msg};
                 return;
             }
-            logMsg          = msg.substr(pos + 4);
+            message         = MessageText{msg.substr(pos + 4)};
             auto contextMsg = msg.substr(1, pos - 1);
 
             if(std::ranges::count(contextMsg, ',') <= 3) { return; }
@@ -230,11 +290,11 @@ namespace uc_log { namespace detail {
             contextMsg.remove_prefix(5);
             auto const functionNameSv = contextMsg;
 
-            ucTime       = *oUcTime;
-            fileName     = fileNameSv;
-            line         = line_;
-            logLevel     = static_cast<uc_log::LogLevel>(logLevel_);
-            functionName = functionNameSv;
+            ucTime   = *oUcTime;
+            callSite = CallSiteRegistry::instance().intern(fileNameSv,
+                                                           line_,
+                                                           static_cast<uc_log::LogLevel>(logLevel_),
+                                                           functionNameSv);
         }
     };
 }}   // namespace uc_log::detail
@@ -395,7 +455,7 @@ struct fmt::formatter<uc_log::detail::LogEntry> {
             fmt::format_to(appender,
                            "{}",
                            fmt::styled(entry.ucTime, fmt::fg(fmt::terminal_color::bright_magenta)));
-            fmt::format_to(appender, " {}: ", entry.logLevel);
+            fmt::format_to(appender, " {}: ", entry.logLevel());
             return fmt::to_string(out);
         }()};
 
@@ -406,23 +466,23 @@ struct fmt::formatter<uc_log::detail::LogEntry> {
                 fmt::format_to(
                   appender,
                   " {}",
-                  fmt::styled(entry.functionName, fmt::fg(fmt::terminal_color::bright_red)));
+                  fmt::styled(entry.functionName(), fmt::fg(fmt::terminal_color::bright_red)));
             }
             fmt::format_to(appender,
                            fmt::fg(fmt::terminal_color::bright_blue),
                            "{}({}:{})",
                            alternate ? "" : " ",
-                           entry.fileName,
-                           entry.line);
+                           entry.fileName(),
+                           entry.line());
             fmt::format_to(appender, "{}", entry.channel);
             return fmt::to_string(out);
         }()};
-        auto const        log_message_size_diff
-          = entry.logMsg.size() - stringSizeWithoutColor(entry.logMsg);
+        auto const logMsg                = entry.logMsg();
+        auto const log_message_size_diff = logMsg.size() - stringSizeWithoutColor(logMsg);
         auto const raw_msg_size = stringSizeWithoutColor(prefix) + stringSizeWithoutColor(postfix);
         auto const align_size
           = width > raw_msg_size ? (width - raw_msg_size) + log_message_size_diff : 0;
 
-        return fmt::format_to(ctx.out(), "{}{:<{}}{}", prefix, entry.logMsg, align_size, postfix);
+        return fmt::format_to(ctx.out(), "{}{:<{}}{}", prefix, logMsg, align_size, postfix);
     }
 };
@@ -29,12 +29,12 @@ inline void writeEntry(std::ostream&                         out,
                "{},{},{:?},{},{:?},{:#},{},{:?}\n",
                toIso8601Utc(recv_time),
                entry.channel.channel,
-               entry.fileName,
-               entry.line,
-               entry.functionName,
-               entry.logLevel,
+               entry.fileName(),
+               entry.line(),
+               entry.functionName(),
+               entry.logLevel(),
                entry.ucTime.time,
-               entry.logMsg);
+               entry.logMsg());
 }
 
 }   // namespace uc_log::detail::logformat
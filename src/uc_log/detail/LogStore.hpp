@@ -0,0 +1,296 @@
+#pragma once
+
+#include "uc_log/LogLevel.hpp"
+#include "uc_log/detail/CallSiteRegistry.hpp"
+#include "uc_log/detail/LogEntry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace uc_log::detail {
+
+struct LogStoreLimits {
+    std::size_t maxEntries{};
+    std::size_t maxBytes{};
+};
+
+enum class LogLineType : std::uint8_t {
+    SingleLine,   // Complete log on one line
+    First,        // First line of multiline log
+    Middle,       // Middle continuation line
+    Last          // Last line of multiline log
+};
+
+// a log counts once, on its single or first line
+inline bool startsLog(LogLineType lineType) {
+    return lineType == LogLineType::SingleLine || lineType == LogLineType::First;
+}
+
+/// One displayed line as read back from the LogStore.
+///
+/// `text` points into the store and is only valid until the next append or eviction. The
+/// accessors mirror LogEntry so rendering and filtering code works on either.
+struct LogLine {
+    std::uint64_t                         seq;
+    std::chrono::system_clock::time_point recv_time;
+    LogEntry::UcTime                      ucTime;
+    LogEntry::Channel                     channel;
+    CallSiteId                            callSite;
+    uc_log::LogLevel                      level;
+    LogLineType                           lineType;
+    std::string_view                      text;
+
+    CallSiteInfo const& callSiteInfo() const { return CallSiteRegistry::instance()[callSite]; }
+
+    std::string_view fileName() const { return callSiteInfo().fileName; }
+
+    std::size_t line() const { return callSiteInfo().line; }
+
+    uc_log::LogLevel logLevel() const { return level; }
+
+    std::string_view functionName() const { return callSiteInfo().functionName; }
+
+    std::string_view logMsg() const { return text; }
+
+    bool startsLog() const { return detail::startsLog(lineType); }
+
+    LogEntry toLogEntry() const { return LogEntry{channel, ucTime, callSite, MessageText{text}}; }
+};
+
+/// Append only, columnar storage of log lines made of fixed size chunks that is trimmed from
+/// the front.
+///
+/// Each chunk keeps one array per field and an arena with the text of its lines, so a line
+/// costs 28 bytes plus its text and no allocation of its own. Every line gets a sequence number
+/// that stays valid until the line is evicted, positions (`operator[]`) are relative to the
+/// oldest line still stored. The store is held to an entry and a byte budget by its owner
+/// through exceeds() and evictChunk(). A snapshot() shares the chunks, so their columns can be
+/// scanned on other threads while the store keeps changing.
+class LogStore {
+public:
+    static constexpr std::size_t ChunkSize = std::size_t{1} << 16;
+
+private:
+    struct Chunk {
+        std::vector<std::chrono::system_clock::time_point> recvTime;
+        std::vector<LogEntry::UcTime>                      ucTime;
+        std::vector<CallSiteId>                            callSite;
+        std::vector<std::uint32_t>                         textEnd;
+        std::vector<std::uint16_t>                         channel;
+        std::vector<uc_log::LogLevel>                      level;
+        std::vector<LogLineType>                           lineType;
+        std::string                                        text;
+
+        static constexpr std::size_t RowBytes
+          = sizeof(std::chrono::system_clock::time_point) + sizeof(LogEntry::UcTime)
+          + sizeof(CallSiteId) + sizeof(std::uint32_t) + sizeof(std::uint16_t)
+          + sizeof(uc_log::LogLevel) + sizeof(LogLineType);
+
+        Chunk() {
+            recvTime.reserve(ChunkSize);
+            ucTime.reserve(ChunkSize);
+            callSite.reserve(ChunkSize);
+            textEnd.reserve(ChunkSize);
+            channel.reserve(ChunkSize);
+            level.reserve(ChunkSize);
+            lineType.reserve(ChunkSize);
+        }
+
+        std::size_t size() const { return lineType.size(); }
+
+        std::size_t bytes() const { return ChunkSize * RowBytes + text.capacity(); }
+
+        LogLine line(std::size_t   i,
+                     std::uint64_t seq) const {
+            std::uint32_t const begin = i == 0 ? 0 : textEnd[i - 1];
+            return LogLine{seq,
+                           recvTime[i],
+                           ucTime[i],
+                           LogEntry::Channel{channel[i]},
+                           callSite[i],
+                           level[i],
+                           lineType[i],
+                           std::string_view{text}.substr(begin, textEnd[i] - begin)};
+        }
+    };
+
+    std::deque<std::shared_ptr<Chunk>> chunks;
+    std::size_t                        headOffset{};   // lines of chunks.front() already dropped
+    std::uint64_t                      firstSeq{};
+    std::size_t                        count{};
+    std::size_t                        chunkBytes{};   // all chunks but the last one
+    std::size_t                        textBytes{};    // text of the last chunk
+
+public:
+    /// The lines of one chunk, one span per field, the first one has sequence number `firstSeq`.
+    struct Columns {
+        std::uint64_t                     firstSeq;
+        std::span<LogEntry::UcTime const> ucTime;
+        std::span<CallSiteId const>       callSite;
+        std::span<std::uint16_t const>    channel;
+        std::span<uc_log::LogLevel const> level;
+        std::span<LogLineType const>      lineType;
+
+        std::size_t size() const { return lineType.size(); }
+    };
+
+    /// Columns of the lines stored when it was taken. Lines appended later are not part of it,
+    /// lines evicted later stay readable until the snapshot is gone.
+    class Snapshot {
+        friend class LogStore;
+
+        std::vector<std::shared_ptr<Chunk const>> chunks;
+        std::vector<Columns>                      columns;
+        std::size_t                               headOffset{};
+        std::uint64_t                             firstSeq{};
+        std::uint64_t                             lastSeq{};
+
+    public:
+        std::size_t chunkCount() const { return columns.size(); }
+
+        Columns const& chunk(std::size_t i) const { return columns[i]; }
+
+        std::uint64_t beginSeq() const { return firstSeq; }
+
+        std::uint64_t endSeq() const { return lastSeq; }
+
+        /// Type of line `seq`, which has to be in [beginSeq(), endSeq()).
+        LogLineType lineType(std::uint64_t seq) const {
+            auto const pos = static_cast<std::size_t>(seq - firstSeq) + headOffset;
+            auto const i   = pos / ChunkSize;
+            return columns[i].lineType[pos % ChunkSize - (i == 0 ? headOffset : 0)];
+        }
+    };
+
+    std::uint64_t push_back(std::chrono::system_clock::time_point recv_time,
+                            LogEntry const&                       entry,
+                            LogLineType                           lineType,
+                            std::string_view                      text) {
+        if(chunks.empty() || chunks.back()->size() == ChunkSize) {
+            if(!chunks.empty()) { chunkBytes += chunks.back()->bytes(); }
+            chunks.push_back(std::make_shared<Chunk>());
+            textBytes = 0;
+        }
+        auto& chunk = *chunks.back();
+        chunk.recvTime.push_back(recv_time);
+        chunk.ucTime.push_back(entry.ucTime);
+        chunk.callSite.push_back(entry.callSite);
+        chunk.channel.push_back(static_cast<std::uint16_t>(entry.channel.channel));
+        chunk.level.push_back(entry.logLevel());
+        chunk.lineType.push_back(lineType);
+        chunk.text.append(text);
+        chunk.textEnd.push_back(static_cast<std::uint32_t>(chunk.text.size()));
+        textBytes = chunk.text.capacity();
+        return firstSeq + count++;
+    }
+
+    LogLine operator[](std::size_t pos) const {
+        auto const i = pos + headOffset;
+        return chunks[i / ChunkSize]->line(i % ChunkSize, firstSeq + pos);
+    }
+
+    /// Line with sequence number `seq`, which has to be in [beginSeq(), endSeq()).
+    LogLine at(std::uint64_t seq) const {
+        return (*this)[static_cast<std::size_t>(seq - firstSeq)];
+    }
+
+    /// uC time of line `seq`, cheaper than at() for searching the time column.
+    LogEntry::UcTime ucTime(std::uint64_t seq) const {
+        auto const pos = static_cast<std::size_t>(seq - firstSeq) + headOffset;
+        return chunks[pos / ChunkSize]->ucTime[pos % ChunkSize];
+    }
+
+    /// Calls `f(Columns const&)` for every chunk from the oldest to the newest line.
+    template<typename F>
+    void forEachChunk(F&& f) const {
+        std::uint64_t seq{firstSeq};
+        std::size_t   offset{headOffset};
+        for(auto const& chunk : chunks) {
+            f(Columns{seq,
+                      std::span{chunk->ucTime}.subspan(offset),
+                      std::span{chunk->callSite}.subspan(offset),
+                      std::span{chunk->channel}.subspan(offset),
+                      std::span{chunk->level}.subspan(offset),
+                      std::span{chunk->lineType}.subspan(offset)});
+            seq += chunk->size() - offset;
+            offset = 0;
+        }
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snapshot;
+        snapshot.chunks.assign(chunks.begin(), chunks.end());
+        snapshot.headOffset = headOffset;
+        snapshot.firstSeq   = firstSeq;
+        snapshot.lastSeq    = endSeq();
+        forEachChunk([&](Columns const& columns) { snapshot.columns.push_back(columns); });
+        return snapshot;
+    }
+
+    std::size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    std::size_t bytes() const {
+        return chunks.empty() ? 0 : chunkBytes + ChunkSize * Chunk::RowBytes + textBytes;
+    }
+
+    /// Sequence number of the oldest stored line.
+    std::uint64_t beginSeq() const { return firstSeq; }
+
+    /// Sequence number the next pushed line will get.
+    std::uint64_t endSeq() const { return firstSeq + count; }
+
+    bool exceeds(LogStoreLimits const& limits) const {
+        return (limits.maxEntries != 0 && count > limits.maxEntries)
+            || (limits.maxBytes != 0 && bytes() > limits.maxBytes);
+    }
+
+    /// Number of lines up to the end of the oldest chunk, what evictChunk() would drop.
+    std::size_t frontChunkSize() const {
+        if(chunks.empty()) { return 0; }
+        return chunks.front()->size() - headOffset;
+    }
+
+    /// Drops the oldest chunk. Keeps the chunk that is currently appended to.
+    void evictChunk() {
+        if(chunks.size() < 2) { return; }
+        count -= frontChunkSize();
+        firstSeq += frontChunkSize();
+        chunkBytes -= chunks.front()->bytes();
+        chunks.pop_front();
+        headOffset = 0;
+    }
+
+    /// Drops the `n` oldest lines. Their memory is released once their chunk is gone.
+    void popFront(std::size_t n) {
+        n = std::min(n, count);
+        while(n != 0 && n >= frontChunkSize() && chunks.size() > 1) {
+            n -= frontChunkSize();
+            evictChunk();
+        }
+        headOffset += n;
+        count -= n;
+        firstSeq += n;
+        if(count == 0) { clear(); }
+    }
+
+    void clear() {
+        firstSeq += count;
+        chunks.clear();
+        headOffset = 0;
+        count      = 0;
+        chunkBytes = 0;
+        textBytes  = 0;
+    }
+};
+
+}   // namespace uc_log::detail
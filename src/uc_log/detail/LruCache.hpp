@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace uc_log::detail {
+
+/// Map of at most `capacity` entries that drops the least recently used one when full.
+template<typename Key,
+         typename Value>
+class LruCache {
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    std::size_t                                         maxSize;
+    Entries                                             entries;   // most recently used first
+    std::unordered_map<Key, typename Entries::iterator> lookup;
+
+public:
+    explicit LruCache(std::size_t capacity) : maxSize{capacity} { lookup.reserve(capacity); }
+
+    /// Value stored for `key` or nullptr, marks it as used.
+    Value const* find(Key const& key) {
+        auto const it = lookup.find(key);
+        if(it == lookup.end()) { return nullptr; }
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->second;
+    }
+
+    void insert(Key const& key,
+                Value      value) {
+        if(auto const it = lookup.find(key); it != lookup.end()) {
+            it->second->second = std::move(value);
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+        if(maxSize == 0) { return; }
+        if(entries.size() == maxSize) {
+            lookup.erase(entries.back().first);
+            entries.pop_back();
+        }
+        entries.emplace_front(key, std::move(value));
+        lookup.emplace(key, entries.begin());
+    }
+
+    std::size_t size() const { return entries.size(); }
+
+    void clear() {
+        entries.clear();
+        lookup.clear();
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "uc_log/MetricInfo.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+namespace uc_log::detail {
+
+using MetricId = std::uint32_t;
+
+/// A metric value in the type it was logged with, integers wider than 53 bits stay exact.
+using MetricValue = std::variant<std::int64_t, std::uint64_t, float, double>;
+
+inline double toDouble(MetricValue const& value) {
+    return std::visit([](auto v) { return static_cast<double>(v); }, value);
+}
+
+struct MetricSample {
+    MetricId    metric;
+    MetricValue value;
+};
+
+/// Immutable metric values of a message, shared between copies of an entry like MessageText.
+class MetricSamples {
+    std::shared_ptr<MetricSample const[]> buffer;
+    std::uint32_t                         count{};
+
+public:
+    MetricSamples() = default;
+
+    explicit MetricSamples(std::span<MetricSample const> samples)
+      : count{static_cast<std::uint32_t>(samples.size())} {
+        if(samples.empty()) { return; }
+        auto storage = std::make_shared_for_overwrite<MetricSample[]>(samples.size());
+        std::ranges::copy(samples, storage.get());
+        buffer = std::move(storage);
+    }
+
+    std::span<MetricSample const> view() const {
+        if(!buffer) { return {}; }
+        return std::span{buffer.get(), count};
+    }
+
+    bool empty() const { return count == 0; }
+};
+
+/// Process wide, append only set of metrics (scope, name, unit).
+///
+/// Works like CallSiteRegistry: interning takes a lock, resolving an id does not, and ids
+/// reach other threads only inside the entries carrying them.
+class MetricRegistry {
+    static constexpr std::size_t ChunkBits = 8;
+    static constexpr std::size_t ChunkSize = std::size_t{1} << ChunkBits;
+    static constexpr std::size_t MaxChunks = 1024;
+
+    using Key = std::tuple<std::string_view, std::string_view, std::string_view>;
+
+    std::array<std::atomic<MetricInfo*>, MaxChunks> chunks{};
+    std::vector<std::unique_ptr<MetricInfo[]>>      ownedChunks;
+    std::map<Key, MetricId>                         ids;
+    mutable std::mutex                              mutex;
+    MetricId                                        nextId{};
+
+    MetricRegistry() = default;
+
+public:
+    static constexpr MetricId Invalid = std::numeric_limits<MetricId>::max();
+
+    MetricRegistry(MetricRegistry const&)            = delete;
+    MetricRegistry& operator=(MetricRegistry const&) = delete;
+
+    static MetricRegistry& instance() {
+        static MetricRegistry registry;
+        return registry;
+    }
+
+    /// Id of the metric, Invalid once the registry is full.
+    MetricId intern(std::string_view scope,
+                    std::string_view name,
+                    std::string_view unit) {
+        std::lock_guard<std::mutex> const lock{mutex};
+        if(auto const it = ids.find(Key{scope, name, unit}); it != ids.end()) { return it->second; }
+        if(nextId == MaxChunks * ChunkSize) { return Invalid; }
+
+        auto& chunk = chunks[nextId >> ChunkBits];
+        if(chunk.load(std::memory_order_relaxed) == nullptr) {
+            ownedChunks.push_back(std::make_unique<MetricInfo[]>(ChunkSize));
+            chunk.store(ownedChunks.back().get(), std::memory_order_release);
+        }
+        auto& info = chunk.load(std::memory_order_relaxed)[nextId & (ChunkSize - 1)];
+        info       = MetricInfo{std::string{scope}, std::string{name}, std::string{unit}};
+        ids.emplace(Key{info.scope, info.name, info.unit}, nextId);
+        return nextId++;
+    }
+
+    /// Number of interned metrics, every id below it can be resolved.
+    std::size_t size() const {
+        std::lock_guard<std::mutex> const lock{mutex};
+        return nextId;
+    }
+
+    MetricInfo const& operator[](MetricId id) const {
+        return chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (ChunkSize - 1)];
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <vector>
+
+namespace uc_log::detail {
+
+struct MetricSeriesLimits {
+    std::size_t rawSamples{};    // newest samples kept as they are
+    std::size_t tierBuckets{};   // buckets kept per tier
+    std::size_t tierFactor{};    // a bucket of tier n summarizes tierFactor^n samples
+    std::size_t tiers{};
+};
+
+/// Time series of one metric at several resolutions, bounded like a round robin database.
+///
+/// The newest samples are kept as they are, every tier keeps the newest buckets of
+/// tierFactor^n consecutive samples, each summarized by min, max, sum and count. Every sample
+/// feeds all levels, so each level reaches further back than the one before at the same memory.
+/// Levels are read as Points, level 0 being the raw samples. As a bucket always covers the same
+/// number of samples, a position in any level is proportional to the samples before it.
+///
+/// Each ring carries a min/max segment tree, so the extent of any range of points is found in
+/// O(log n). A plot draws from the finest level reaching back far enough and asks for the
+/// extent of every column, which costs O(width log n) at any zoom and loses no spike.
+class MetricSeries {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    struct Sample {
+        TimePoint time;
+        double    value;
+    };
+
+    struct Point {
+        TimePoint     first;   // time of the first and the last sample
+        TimePoint     last;
+        double        min;
+        double        max;
+        double        sum;
+        std::uint64_t count;
+
+        double mean() const { return sum / static_cast<double>(count); }
+    };
+
+    struct Extent {
+        double min{std::numeric_limits<double>::infinity()};
+        double max{-std::numeric_limits<double>::infinity()};
+
+        Extent operator|(Extent const& other) const {
+            return Extent{std::min(min, other.min), std::max(max, other.max)};
+        }
+    };
+
+private:
+    static Extent extentOf(Sample const& sample) { return Extent{sample.value, sample.value}; }
+
+    static Extent extentOf(Point const& point) { return Extent{point.min, point.max}; }
+
+    // keeps the newest `capacity` elements, grows up to it on demand
+    //
+    // `tree` holds the inner nodes of a bottom up segment tree over the slots, node i covers
+    // nodes 2i and 2i + 1 and the leaves n + slot are the slots themselves, n being the
+    // reserved slot count. Unused slots are empty extents.
+    template<typename T>
+    class Ring {
+        std::vector<T>      slots;
+        std::vector<Extent> tree;
+        std::size_t         capacity;
+        std::size_t         head{};   // slot of the oldest element once full
+        std::uint64_t       overwritten{};
+
+        Extent node(std::size_t i) const {
+            auto const n = tree.size();
+            if(i < n) { return tree[i]; }
+            return i - n < slots.size() ? extentOf(slots[i - n]) : Extent{};
+        }
+
+        void rebuild() {
+            tree.assign(slots.capacity(), Extent{});
+            for(auto i = tree.size(); i-- > 1;) { tree[i] = node(2 * i) | node(2 * i + 1); }
+        }
+
+        void update(std::size_t slot) {
+            for(auto i = (slot + tree.size()) / 2; i >= 1; i /= 2) {
+                tree[i] = node(2 * i) | node(2 * i + 1);
+            }
+        }
+
+        // slots [first, last)
+        Extent query(std::size_t first,
+                     std::size_t last) const {
+            Extent result{};
+            for(first += tree.size(), last += tree.size(); first < last; first /= 2, last /= 2) {
+                if(first % 2 == 1) { result = result | node(first++); }
+                if(last % 2 == 1) { result = result | node(--last); }
+            }
+            return result;
+        }
+
+    public:
+        explicit Ring(std::size_t capacity_) : capacity{std::max(capacity_, std::size_t{1})} {}
+
+        std::size_t size() const { return slots.size(); }
+
+        std::uint64_t dropped() const { return overwritten; }
+
+        T const& operator[](std::size_t i) const {
+            i += head;
+            return slots[i < slots.size() ? i : i - slots.size()];
+        }
+
+        void push_back(T const& value) {
+            if(slots.size() < capacity) {
+                bool const grow = slots.size() == slots.capacity();
+                if(grow) {
+                    slots.reserve(std::min(capacity, std::max(slots.size() * 2, std::size_t{64})));
+                }
+                slots.push_back(value);
+                if(grow) {
+                    rebuild();
+                } else {
+                    update(slots.size() - 1);
+                }
+                return;
+            }
+            slots[head] = value;
+            update(head);
+            head = head + 1 == capacity ? 0 : head + 1;
+            ++overwritten;
+        }
+
+        /// Extent of the elements [first, last), oldest first.
+        Extent extent(std::size_t first,
+                      std::size_t last) const {
+            if(first >= last) { return Extent{}; }
+            first = (head + first) % slots.size();
+            last  = (head + last) % slots.size();
+            if(first < last) { return query(first, last); }
+            return query(first, slots.size()) | query(0, last);
+        }
+
+        void clear() {
+            slots.clear();
+            tree.clear();
+            head        = 0;
+            overwritten = 0;
+        }
+
+        std::size_t bytes() const {
+            return slots.capacity() * sizeof(T) + tree.capacity() * sizeof(Extent);
+        }
+    };
+
+    struct Tier {
+        std::uint64_t bucketSize;
+        Ring<Point>   buckets;
+        Point         open{};   // bucket still being filled, count 0 while empty
+    };
+
+    Ring<Sample>      raw;
+    std::vector<Tier> tiers;
+    std::uint64_t     total{};
+
+public:
+    explicit MetricSeries(MetricSeriesLimits const& limits) : raw{limits.rawSamples} {
+        std::uint64_t bucketSize{1};
+        for(std::size_t n{}; n < limits.tiers; ++n) {
+            bucketSize *= std::max(limits.tierFactor, std::size_t{2});
+            tiers.push_back(Tier{bucketSize, Ring<Point>{limits.tierBuckets}});
+        }
+    }
+
+    void push_back(TimePoint time,
+                   double    value) {
+        raw.push_back(Sample{time, value});
+        for(auto& tier : tiers) {
+            auto& open = tier.open;
+            if(open.count == 0) { open = Point{time, time, value, value, 0.0, 0}; }
+            open.last = time;
+            open.min  = std::min(open.min, value);
+            open.max  = std::max(open.max, value);
+            open.sum += value;
+            if(++open.count == tier.bucketSize) {
+                tier.buckets.push_back(open);
+                open = Point{};
+            }
+        }
+        ++total;
+    }
+
+    bool empty() const { return total == 0; }
+
+    /// Samples pushed since the series was created or cleared, including the ones dropped.
+    std::uint64_t totalCount() const { return total; }
+
+    Sample const& latest() const { return raw[raw.size() - 1]; }
+
+    std::size_t levels() const { return 1 + tiers.size(); }
+
+    std::size_t size(std::size_t level) const {
+        if(level == 0) { return raw.size(); }
+        auto const& tier = tiers[level - 1];
+        return tier.buckets.size() + (tier.open.count != 0 ? 1 : 0);
+    }
+
+    Point point(std::size_t level,
+                std::size_t i) const {
+        if(level == 0) {
+            auto const& sample = raw[i];
+            return Point{sample.time, sample.time, sample.value, sample.value, sample.value, 1};
+        }
+        auto const& tier = tiers[level - 1];
+        return i < tier.buckets.size() ? tier.buckets[i] : tier.open;
+    }
+
+    /// First point of `level` with samples at or after `time`.
+    std::size_t lowerBound(std::size_t level,
+                           TimePoint   time) const {
+        return *std::ranges::partition_point(std::views::iota(std::size_t{}, size(level)),
+                                             [&](std::size_t i) {
+                                                 return point(level, i).last < time;
+                                             });
+    }
+
+    /// Whether `level` still holds every sample from `time` on.
+    bool covers(std::size_t level,
+                TimePoint   time) const {
+        auto const dropped = level == 0 ? raw.dropped() : tiers[level - 1].buckets.dropped();
+        return dropped == 0 || (size(level) != 0 && point(level, 0).first <= time);
+    }
+
+    /// Time of the oldest sample any level still knows about.
+    TimePoint begin() const {
+        auto oldest = TimePoint::max();
+        for(std::size_t level{}; level < levels(); ++level) {
+            if(size(level) != 0) { oldest = std::min(oldest, point(level, 0).first); }
+        }
+        return oldest;
+    }
+
+    /// Finest level that holds all samples from `time` on, the coarsest if none does.
+    std::size_t levelSince(TimePoint time) const {
+        for(std::size_t level{}; level + 1 < levels(); ++level) {
+            if(covers(level, time)) { return level; }
+        }
+        return levels() - 1;
+    }
+
+    /// Smallest and largest value of the points [first, last) of `level`.
+    Extent extent(std::size_t level,
+                  std::size_t first,
+                  std::size_t last) const {
+        if(level == 0) { return raw.extent(first, last); }
+        auto const& tier   = tiers[level - 1];
+        auto const  closed = tier.buckets.size();
+        auto const  result = tier.buckets.extent(first, std::min(last, closed));
+        return last > closed && first <= closed ? result | extentOf(tier.open) : result;
+    }
+
+    /// Number of samples in the points [first, last) of `level`.
+    std::uint64_t samples(std::size_t level,
+                          std::size_t first,
+                          std::size_t last) const {
+        if(level == 0 || first >= last) { return last - std::min(first, last); }
+        auto const& tier   = tiers[level - 1];
+        auto const  closed = std::min(last, tier.buckets.size());
+        auto const  full   = closed > first ? closed - first : 0;
+        return full * tier.bucketSize + (last > tier.buckets.size() ? tier.open.count : 0);
+    }
+
+    std::size_t bytes() const {
+        std::size_t bytes = raw.bytes();
+        for(auto const& tier : tiers) { bytes += tier.buckets.bytes(); }
+        return bytes;
+    }
+
+    void clear() {
+        raw.clear();
+        for(auto& tier : tiers) {
+            tier.buckets.clear();
+            tier.open = Point{};
+        }
+        total = 0;
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace uc_log::detail {
+
+struct PollSchedulerConfig {
+    std::chrono::microseconds minInterval{100};
+    std::chrono::microseconds maxInterval{20'000};
+    std::chrono::microseconds latencyTarget{10'000};
+    std::size_t               upBufferSize{1024};
+    double                    targetFill{0.5};
+};
+
+/// Picks the pause between two RTT sweeps from the observed traffic.
+///
+/// Every channel keeps a smoothed byte rate and a capacity estimate (the configured up-buffer
+/// size, raised to the largest single read seen). The next interval is the time until the busiest
+/// channel would reach `targetFill` of its capacity, clamped to the configured bounds and the
+/// latency target. Overflows reported by the probe or reads that drained a full buffer drop the
+/// interval to the minimum immediately; growing back is rate limited so a burst right after a
+/// quiet phase still finds a short interval.
+class PollScheduler {
+public:
+    using Clock  = std::chrono::steady_clock;
+    using Config = PollSchedulerConfig;
+
+private:
+    static constexpr auto   RateTimeConstant = std::chrono::milliseconds{100};
+    static constexpr double MaxGrowth        = 1.5;
+
+    struct ChannelState {
+        double      bytesPerSecond{};
+        std::size_t capacity{};
+    };
+
+    Config                    config;
+    std::vector<ChannelState> channels;
+    Clock::time_point         lastSweep{Clock::now()};
+    std::uint32_t             lastBytesRead{};
+    int                       lastOverflowCount{};
+    bool                      haveStatus{};
+    Clock::duration           current{};
+    double                    overflowsPerSecond{};
+
+public:
+    explicit PollScheduler(Config const& config_ = {}) : config{config_} { reset(0); }
+
+    void setConfig(Config const& config_) {
+        config = config_;
+        reset(channels.size());
+    }
+
+    Config const& getConfig() const { return config; }
+
+    void reset(std::size_t numChannels) {
+        channels.assign(numChannels,
+                        ChannelState{0.0, std::max(config.upBufferSize, std::size_t{1})});
+        lastSweep          = Clock::now();
+        haveStatus         = false;
+        current            = config.minInterval;
+        overflowsPerSecond = 0.0;
+    }
+
+    /// Feeds the result of one sweep and returns the pause until the next one.
+    Clock::duration update(std::span<std::size_t const> bytesPerChannel,
+                           std::uint32_t                numBytesRead,
+                           int                          hostOverflowCount) {
+        auto const now     = Clock::now();
+        auto const seconds = std::max(std::chrono::duration<double>(now - lastSweep).count(), 1e-6);
+        lastSweep          = now;
+
+        auto const alpha
+          = 1.0 - std::exp(-seconds / std::chrono::duration<double>(RateTimeConstant).count());
+
+        int overflows{};
+        // the probe may read ahead of rttRead, count whatever it transferred since last sweep
+        std::size_t probeBytes{};
+        if(haveStatus) {
+            overflows  = std::max(hostOverflowCount - lastOverflowCount, 0);
+            probeBytes = numBytesRead - lastBytesRead;
+        }
+        haveStatus        = true;
+        lastBytesRead     = numBytesRead;
+        lastOverflowCount = hostOverflowCount;
+        overflowsPerSecond
+          += alpha * (static_cast<double>(overflows) / seconds - overflowsPerSecond);
+
+        std::size_t sweepBytes{};
+        for(auto bytes : bytesPerChannel) { sweepBytes += bytes; }
+        auto const probeScale
+          = sweepBytes != 0 && probeBytes > sweepBytes
+            ? static_cast<double>(probeBytes) / static_cast<double>(sweepBytes)
+            : 1.0;
+
+        auto const upperBound = std::max<Clock::duration>(
+          config.minInterval,
+          std::min<Clock::duration>(config.maxInterval, config.latencyTarget));
+
+        bool drainedFullBuffer{};
+        auto next = std::chrono::duration<double>(upperBound);
+        for(std::size_t i{}; i < channels.size() && i < bytesPerChannel.size(); ++i) {
+            auto&      channel = channels[i];
+            auto const bytes   = bytesPerChannel[i];
+            if(bytes >= channel.capacity) {
+                drainedFullBuffer = true;
+                channel.capacity  = bytes;
+            }
+            auto const rate = static_cast<double>(bytes) * probeScale / seconds;
+            channel.bytesPerSecond += alpha * (rate - channel.bytesPerSecond);
+            if(channel.bytesPerSecond > 0.0) {
+                auto const untilFill = static_cast<double>(channel.capacity) * config.targetFill
+                                     / channel.bytesPerSecond;
+                next = std::min(next, std::chrono::duration<double>(untilFill));
+            }
+        }
+
+        if(overflows != 0 || drainedFullBuffer) {
+            current = config.minInterval;
+            return current;
+        }
+
+        auto const grown = std::chrono::duration<double>(current) * MaxGrowth;
+        current          = std::clamp<Clock::duration>(
+          std::chrono::duration_cast<Clock::duration>(std::min(next, grown)),
+          config.minInterval,
+          upperBound);
+        return current;
+    }
+
+    Clock::duration interval() const { return current; }
+
+    double overflowRate() const { return overflowsPerSecond; }
+};
+
+}   // namespace uc_log::detail
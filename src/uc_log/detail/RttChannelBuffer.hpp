@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace uc_log::detail {
+
+/// Receive buffer of a single RTT up-channel.
+///
+/// Parsed frames are consumed by advancing a read offset, so removing a frame never moves the
+/// remaining bytes. The unparsed tail is only moved to the front when the next chunk does not fit
+/// behind it, and the buffer rewinds for free whenever it has been drained completely.
+class RttChannelBuffer {
+    std::vector<std::byte> storage;
+    std::size_t            readPos{};
+    std::size_t            writePos{};
+
+public:
+    /// Returns writable space for at least `size` bytes behind the unparsed data.
+    std::span<std::byte> prepare(std::size_t size) {
+        if(storage.size() - writePos < size) {
+            compact();
+            if(storage.size() - writePos < size) { storage.resize(writePos + size); }
+        }
+        return std::span{storage}.subspan(writePos, size);
+    }
+
+    /// Marks `size` bytes of the span returned by prepare() as received.
+    void commit(std::size_t size) { writePos += std::min(size, storage.size() - writePos); }
+
+    void append(std::span<std::byte const> bytes) {
+        std::ranges::copy(bytes, prepare(bytes.size()).begin());
+        commit(bytes.size());
+    }
+
+    std::span<std::byte const> data() const {
+        return std::span{storage}.subspan(readPos, writePos - readPos);
+    }
+
+    std::size_t size() const { return writePos - readPos; }
+
+    bool empty() const { return readPos == writePos; }
+
+    void consume(std::size_t size) {
+        readPos += std::min(size, writePos - readPos);
+        if(readPos == writePos) {
+            readPos  = 0;
+            writePos = 0;
+        }
+    }
+
+    void clear() {
+        readPos  = 0;
+        writePos = 0;
+    }
+
+private:
+    void compact() {
+        if(readPos == 0) { return; }
+        auto const first = std::next(storage.begin(), static_cast<std::ptrdiff_t>(readPos));
+        auto const last  = std::next(storage.begin(), static_cast<std::ptrdiff_t>(writePos));
+        std::copy(first, last, storage.begin());
+        writePos -= readPos;
+        readPos = 0;
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "remote_fmt/remote_fmt.hpp"
+#include "uc_log/detail/RttChannelBuffer.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace uc_log::detail {
+
+/// Turns the raw byte stream of one RTT up-channel into formatted messages.
+class RttChannelParser {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static constexpr auto Timeout = std::chrono::milliseconds{100};
+
+    RttChannelBuffer  buffer;
+    Clock::time_point lastValidRead{Clock::now()};
+
+public:
+    void append(std::span<std::byte const> bytes) { buffer.append(bytes); }
+
+    /// Parses every complete message in the buffer and returns how many were printed.
+    std::size_t parse(std::stop_token const&                       stoken,
+                      std::uint32_t                                channel,
+                      std::unordered_map<std::uint16_t,
+                                         std::string> const&       stringConstantsMap,
+                      std::function<void(std::size_t,
+                                         std::string_view)> const& printF,
+                      std::function<void(std::string_view)> const& errorMessagef) {
+        if(buffer.empty()) {
+            lastValidRead = Clock::now();
+            return 0;
+        }
+
+        std::size_t messages{};
+        while(!stoken.stop_requested()) {
+            auto const [output_stream, subrange, unparsed_bytes]
+              = remote_fmt::parse(buffer.data(), stringConstantsMap, errorMessagef);
+            buffer.consume(buffer.size() - subrange.size());
+            if(unparsed_bytes != 0) {
+                errorMessagef(fmt::format("channel {} corrupted data removed {} byte{}",
+                                          channel,
+                                          unparsed_bytes,
+                                          unparsed_bytes == 1 ? "" : "s"));
+            }
+            if(output_stream) {
+                lastValidRead = Clock::now();
+                ++messages;
+                printF(channel, *output_stream);
+                continue;
+            }
+            break;
+        }
+        return messages;
+    }
+
+    /// Drops one byte when the channel has been stuck on an incomplete message for too long and
+    /// the target was not halted recently, so a corrupted frame cannot block the channel forever.
+    void dropStaleByte(std::uint32_t                                channel,
+                       Clock::time_point                            lastHaltDetected,
+                       std::function<void(std::string_view)> const& errorMessagef) {
+        auto const now = Clock::now();
+        if((now > lastValidRead + Timeout) && (now > lastHaltDetected + std::chrono::seconds{60})
+           && !buffer.empty())
+        {
+            buffer.consume(1);
+            errorMessagef(fmt::format("channel {} timeout removed 1 byte", channel));
+        }
+    }
+
+    std::size_t pending() const { return buffer.size(); }
+};
+
+}   // namespace uc_log::detail
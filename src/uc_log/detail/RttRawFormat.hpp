@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// .rttraw layout, all integers little endian:
+//   header:  "UCRTTRAW" u16 version
+//   session: u8 1, u64 time_ns, u64 catalog_hash, u32 num_channels
+//   chunk:   u8 2, u64 time_ns, u32 channel, u32 size, size bytes as returned by rttRead
+// time_ns counts from opening the file, every reconnect starts a new session record.
+namespace uc_log::detail::rttraw {
+
+inline constexpr std::string_view Magic{"UCRTTRAW"};
+inline constexpr std::uint16_t    Version{1};
+
+enum class RecordType : std::uint8_t { Session = 1, Chunk = 2 };
+
+struct Record {
+    RecordType               type{};
+    std::chrono::nanoseconds time{};
+    std::uint64_t            catalogHash{};
+    std::uint32_t            numChannels{};
+    std::uint32_t            channel{};
+    std::vector<std::byte>   bytes{};
+};
+
+/// FNV-1a over the catalog in id order, so a replay can tell whether it decodes with the same
+/// string constants the capture was made with.
+inline std::uint64_t catalogHash(std::unordered_map<std::uint16_t, std::string> const& catalog) {
+    std::uint64_t hash{0xcbf29ce484222325};
+    auto const    mix = [&](std::string_view bytes) {
+        for(auto c : bytes) {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= 0x100000001b3;
+        }
+    };
+    for(auto const& [id, str] : std::map<std::uint16_t, std::string_view>{catalog.begin(),
+                                                                          catalog.end()})
+    {
+        std::array const idBytes{static_cast<char>(id & 0xFF), static_cast<char>(id >> 8)};
+        mix(std::string_view{idBytes.data(), idBytes.size()});
+        mix(str);
+        mix(std::string_view{"\0", 1});
+    }
+    return hash;
+}
+
+namespace detail {
+    template<typename T>
+    void put(std::ostream& out,
+             T             value) {
+        std::array<char, sizeof(T)> bytes{};
+        for(auto& b : bytes) {
+            b     = static_cast<char>(value & 0xFF);
+            value = static_cast<T>(value >> 8);
+        }
+        out.write(bytes.data(), bytes.size());
+    }
+
+    template<typename T>
+    bool get(std::istream& in,
+             T&            value) {
+        std::array<char, sizeof(T)> bytes{};
+        if(!in.read(bytes.data(), bytes.size())) { return false; }
+        value = 0;
+        for(auto it = bytes.rbegin(); it != bytes.rend(); ++it) {
+            value = static_cast<T>((value << 8) | static_cast<std::uint8_t>(*it));
+        }
+        return true;
+    }
+}   // namespace detail
+
+class Writer {
+    using Clock = std::chrono::steady_clock;
+
+    std::ofstream     file;
+    Clock::time_point start{};
+
+    std::uint64_t now() const {
+        return static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+public:
+    bool open(std::filesystem::path const& path) {
+        file.close();
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if(!file) { return false; }
+        start = Clock::now();
+        file.write(Magic.data(), static_cast<std::streamsize>(Magic.size()));
+        detail::put(file, Version);
+        return static_cast<bool>(file);
+    }
+
+    bool isOpen() const { return file.is_open(); }
+
+    void close() { file.close(); }
+
+    void flush() { file.flush(); }
+
+    void writeSession(std::uint64_t hash,
+                      std::uint32_t numChannels) {
+        detail::put(file, static_cast<std::uint8_t>(RecordType::Session));
+        detail::put(file, now());
+        detail::put(file, hash);
+        detail::put(file, numChannels);
+        file.flush();
+    }
+
+    void writeChunk(std::uint32_t              channel,
+                    std::span<std::byte const> bytes) {
+        detail::put(file, static_cast<std::uint8_t>(RecordType::Chunk));
+        detail::put(file, now());
+        detail::put(file, channel);
+        detail::put(file, static_cast<std::uint32_t>(bytes.size()));
+        file.write(reinterpret_cast<char const*>(bytes.data()),
+                   static_cast<std::streamsize>(bytes.size()));
+    }
+};
+
+class FileReader {
+    std::ifstream file;
+
+public:
+    /// Opens a capture and checks its header, returns an error description on failure.
+    std::optional<std::string> open(std::filesystem::path const& path) {
+        file.close();
+        file.open(path, std::ios::binary);
+        if(!file) { return "failed to open " + path.string(); }
+        std::array<char, Magic.size()> magic{};
+        std::uint16_t                   version{};
+        if(!file.read(magic.data(), magic.size())
+           || std::string_view{magic.data(), magic.size()} != Magic || !detail::get(file, version))
+        {
+            return path.string() + " is not a rttraw file";
+        }
+        if(version != Version) {
+            return path.string() + " has unsupported rttraw version " + std::to_string(version);
+        }
+        return std::nullopt;
+    }
+
+    /// Reads the next record, std::nullopt at the end of the file or on a truncated record.
+    std::optional<Record> next() {
+        std::uint8_t  type{};
+        std::uint64_t time{};
+        if(!detail::get(file, type) || !detail::get(file, time)) { return std::nullopt; }
+
+        Record record{};
+        record.type = static_cast<RecordType>(type);
+        record.time = std::chrono::nanoseconds{static_cast<std::int64_t>(time)};
+        switch(record.type) {
+        case RecordType::Session:
+            if(!detail::get(file, record.catalogHash) || !detail::get(file, record.numChannels)) {
+                return std::nullopt;
+            }
+            return record;
+        case RecordType::Chunk:
+            {
+                std::uint32_t size{};
+                if(!detail::get(file, record.channel) || !detail::get(file, size)) {
+                    return std::nullopt;
+                }
+                record.bytes.resize(size);
+                if(!file.read(reinterpret_cast<char*>(record.bytes.data()),
+                              static_cast<std::streamsize>(size)))
+                {
+                    return std::nullopt;
+                }
+                return record;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+}   // namespace uc_log::detail::rttraw
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "uc_log/SinkStats.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace uc_log::detail {
+
+/// Feeds one sink from its own thread through a bounded queue.
+///
+/// push() only copies the items into the queue, so a sink that is slow or blocked (the GUI
+/// while it renders) never holds up the others. What happens when the queue is full is
+/// decided by the OverflowPolicy; the worker hands everything queued so far to the sink in
+/// one call.
+template<typename Item>
+class SinkWorker {
+public:
+    static constexpr std::uint64_t SampleEvery = 16;
+
+private:
+    std::string                                name;
+    OverflowPolicy                             policy;
+    std::size_t                                capacity;
+    std::function<void(std::span<Item const>)> sink;
+
+    std::deque<Item>            queue;
+    std::size_t                 maxDepth{};
+    std::uint64_t               delivered{};
+    std::uint64_t               dropped{};
+    std::uint64_t               overflowCount{};
+    std::mutex                  mutex;
+    std::condition_variable_any notEmpty;
+    std::condition_variable_any notFull;
+    std::jthread                thread;
+
+    void run(std::stop_token const& stoken) {
+        std::vector<Item> batch;
+        while(true) {
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                notEmpty.wait(lock, stoken, [this] { return !queue.empty(); });
+                // drain what is left on shutdown so a lossless sink stays lossless
+                if(queue.empty()) { return; }
+                batch.assign(std::make_move_iterator(queue.begin()),
+                             std::make_move_iterator(queue.end()));
+                queue.clear();
+            }
+            notFull.notify_all();
+            sink(std::span<Item const>{batch});
+            {
+                std::lock_guard<std::mutex> const lock{mutex};
+                delivered += batch.size();
+            }
+            batch.clear();
+        }
+    }
+
+    // called with the lock held and the queue full, true if item should still be queued
+    bool makeRoom(std::unique_lock<std::mutex>& lock) {
+        switch(policy) {
+        case OverflowPolicy::Block:
+            notEmpty.notify_one();
+            notFull.wait(lock, thread.get_stop_token(), [this] { return queue.size() < capacity; });
+            // woken by the stop the item goes over capacity, run() drains it before it returns
+            return true;
+        case OverflowPolicy::DropOldest:
+            queue.pop_front();
+            ++dropped;
+            return true;
+        case OverflowPolicy::Sample:
+            if(++overflowCount % SampleEvery != 0) {
+                ++dropped;
+                return false;
+            }
+            queue.pop_front();
+            ++dropped;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    template<typename SinkF>
+    SinkWorker(std::string    name_,
+               OverflowPolicy policy_,
+               std::size_t    capacity_,
+               SinkF&&        sinkf)
+      : name{std::move(name_)}
+      , policy{policy_}
+      , capacity{std::max<std::size_t>(capacity_, 1)}
+      , sink{std::forward<SinkF>(sinkf)}
+      , thread{[this](std::stop_token stoken) { run(stoken); }} {}
+
+    SinkWorker(SinkWorker const&)            = delete;
+    SinkWorker& operator=(SinkWorker const&) = delete;
+
+    void push(std::span<Item const> items) {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            for(auto const& item : items) {
+                if(queue.size() >= capacity && !makeRoom(lock)) { continue; }
+                queue.push_back(item);
+            }
+            maxDepth = std::max(maxDepth, queue.size());
+        }
+        notEmpty.notify_one();
+    }
+
+    SinkStats stats() {
+        std::lock_guard<std::mutex> const lock{mutex};
+        return SinkStats{.name      = name,
+                         .policy    = policy,
+                         .depth     = queue.size(),
+                         .maxDepth  = maxDepth,
+                         .capacity  = capacity,
+                         .delivered = delivered,
+                         .dropped   = dropped};
+    }
+};
+
+}   // namespace uc_log::detail
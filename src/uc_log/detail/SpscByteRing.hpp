@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace uc_log::detail {
+
+/// Lock-free single-producer/single-consumer byte ring.
+///
+/// The producer writes straight into prepareWrite() and publishes with commitWrite(); the consumer
+/// reads contiguous pieces through readable() and releases them with consume(). Both sides may
+/// see less than the full free/used space when the region wraps, so callers loop until empty.
+class SpscByteRing {
+    std::vector<std::byte> storage;
+    std::size_t            mask;
+
+    alignas(64) std::atomic<std::size_t> head{};   // written by the producer
+    alignas(64) std::atomic<std::size_t> tail{};   // written by the consumer
+
+public:
+    explicit SpscByteRing(std::size_t capacity)
+      : storage(std::bit_ceil(std::max(capacity, std::size_t{2})))
+      , mask{storage.size() - 1} {}
+
+    SpscByteRing(SpscByteRing const&)            = delete;
+    SpscByteRing& operator=(SpscByteRing const&) = delete;
+
+    std::size_t capacity() const { return storage.size(); }
+
+    std::size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    std::span<std::byte> prepareWrite() {
+        auto const h      = head.load(std::memory_order_relaxed);
+        auto const t      = tail.load(std::memory_order_acquire);
+        auto const free   = storage.size() - (h - t);
+        auto const offset = h & mask;
+        return std::span{storage}.subspan(offset, std::min(free, storage.size() - offset));
+    }
+
+    void commitWrite(std::size_t count) {
+        head.store(head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    std::span<std::byte const> readable() const {
+        auto const t      = tail.load(std::memory_order_relaxed);
+        auto const h      = head.load(std::memory_order_acquire);
+        auto const offset = t & mask;
+        return std::span{storage}.subspan(offset, std::min(h - t, storage.size() - offset));
+    }
+
+    void consume(std::size_t count) {
+        tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+};
+
+}   // namespace uc_log::detail
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <chrono>
+
+namespace uc_log::detail {
+
+/// An entry together with the host time it was received at, the unit sinks are fed with.
+template<typename Entry>
+struct TimedEntry {
+    using entry_type = Entry;
+
+    std::chrono::system_clock::time_point recv_time;
+    Entry                                 entry;
+};
+
+}   // namespace uc_log::detail
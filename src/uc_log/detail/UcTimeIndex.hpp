@@ -0,0 +1,86 @@
+#pragma once
+
+#include "uc_log/detail/LogEntry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <ranges>
+
+namespace uc_log::detail {
+
+/// Splits the lines of a LogStore into segments in which the uC time does not go backwards.
+///
+/// The uC time starts over with every boot of the target, within a boot lines arrive sorted by
+/// it. A time window therefore maps to one range of sequence numbers per segment, found by
+/// binary search over the store's time column. Lines that arrive out of order start a segment of
+/// their own, which keeps the ranges exact at the cost of a few more segments.
+class UcTimeIndex {
+public:
+    struct Segment {
+        std::uint64_t    beginSeq;
+        std::uint64_t    endSeq;
+        LogEntry::UcTime first;
+        LogEntry::UcTime last;
+    };
+
+    struct SeqRange {
+        std::uint64_t begin;
+        std::uint64_t end;
+    };
+
+private:
+    std::deque<Segment> segmentList;
+
+public:
+    std::deque<Segment> const& segments() const { return segmentList; }
+
+    void push_back(std::uint64_t    seq,
+                   LogEntry::UcTime ucTime) {
+        if(segmentList.empty() || segmentList.back().endSeq != seq
+           || ucTime < segmentList.back().last)
+        {
+            segmentList.push_back(Segment{seq, seq + 1, ucTime, ucTime});
+            return;
+        }
+        segmentList.back().endSeq = seq + 1;
+        segmentList.back().last   = ucTime;
+    }
+
+    /// Forgets the lines before `seq`, called after the store dropped them.
+    void dropBefore(std::uint64_t seq) {
+        while(!segmentList.empty() && segmentList.front().endSeq <= seq) {
+            segmentList.pop_front();
+        }
+        if(!segmentList.empty() && segmentList.front().beginSeq < seq) {
+            segmentList.front().beginSeq = seq;
+        }
+    }
+
+    /// Lines of `segment` with a uC time in [minTime, maxTime]. `timeAt(seq)` reads the time of a
+    /// stored line.
+    template<typename TimeAt>
+    static SeqRange range(Segment const&           segment,
+                          std::chrono::nanoseconds minTime,
+                          std::chrono::nanoseconds maxTime,
+                          TimeAt&&                 timeAt) {
+        if(maxTime < segment.first.time || segment.last.time < minTime) {
+            return SeqRange{segment.endSeq, segment.endSeq};
+        }
+        auto const seqs  = std::views::iota(segment.beginSeq, segment.endSeq);
+        auto const begin = minTime <= segment.first.time
+                           ? segment.beginSeq
+                           : *std::ranges::partition_point(seqs, [&](std::uint64_t seq) {
+                                 return timeAt(seq) < minTime;
+                             });
+        auto const end   = segment.last.time <= maxTime
+                           ? segment.endSeq
+                           : *std::ranges::partition_point(seqs, [&](std::uint64_t seq) {
+                                 return timeAt(seq) <= maxTime;
+                             });
+        return SeqRange{begin, std::max(begin, end)};   // empty for minTime > maxTime
+    }
+};
+
+}   // namespace uc_log::detail
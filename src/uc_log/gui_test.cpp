@@ -1,4 +1,5 @@
 #include "uc_log/FTXUIGui.hpp"
+#include "uc_log/metric_utils.hpp"
 
 #include <chrono>
 #include <functional>
@@ -92,14 +93,21 @@ constexpr std::array functionLines{20, 50, 129, 10023};
 template<typename Gen>
 void updateMessage(uc_log::detail::LogEntry& e,
                    Gen&                      gen) {
-    e.channel.channel = std::uniform_int_distribution<std::size_t>{0, 5}(gen);
-    e.logLevel        = static_cast<uc_log::LogLevel>(std::uniform_int_distribution<std::uint8_t>{
+    e.channel.channel   = std::uniform_int_distribution<std::size_t>{0, 5}(gen);
+    auto const logLevel = static_cast<uc_log::LogLevel>(std::uniform_int_distribution<std::uint8_t>{
       static_cast<std::uint8_t>(uc_log::LogLevel::trace),
       static_cast<std::uint8_t>(uc_log::LogLevel::crit)}(gen));
-    std::ranges::sample(fileNames, &e.fileName, 1, gen);
-    std::ranges::sample(logMessages, &e.logMsg, 1, gen);
-    std::ranges::sample(functionNames, &e.functionName, 1, gen);
-    std::ranges::sample(functionLines, &e.line, 1, gen);
+    std::string_view fileName;
+    std::string_view logMsg;
+    std::string_view functionName;
+    std::size_t      line{};
+    std::ranges::sample(fileNames, &fileName, 1, gen);
+    std::ranges::sample(logMessages, &logMsg, 1, gen);
+    std::ranges::sample(functionNames, &functionName, 1, gen);
+    std::ranges::sample(functionLines, &line, 1, gen);
+    e.callSite
+      = uc_log::detail::CallSiteRegistry::instance().intern(fileName, line, logLevel, functionName);
+    e.message = uc_log::detail::MessageText{logMsg};
 }
 
 static void updateStatus(Status& status) {
@@ -148,17 +156,20 @@ int main() {
                 updateStatus(reader.status);
             }
             e.ucTime.time += addTime;
+            uc_log::extractMetrics(e);
             gui.add(std::chrono::system_clock::now(), e);
 
             {
-                std::string originalMessage = e.logMsg;
+                std::string originalMessage{e.logMsg()};
                 for(auto const& [meta, metricFunction] : metricFunctions) {
-                    e.logMsg = std::format("{} @METRIC({}::{}[{}]={})",
-                                           originalMessage,
-                                           std::get<0>(meta),
-                                           std::get<1>(meta),
-                                           std::get<2>(meta),
-                                           metricFunction(e.ucTime.time));
+                    e.message = uc_log::detail::MessageText{
+                      std::format("{} @METRIC({}::{}[{}]={})",
+                                  originalMessage,
+                                  std::get<0>(meta),
+                                  std::get<1>(meta),
+                                  std::get<2>(meta),
+                                  metricFunction(e.ucTime.time))};
+                    uc_log::extractMetrics(e);
                     gui.add(std::chrono::system_clock::now(), e);
                 }
             }
@@ -7,10 +7,17 @@
 #include "uc_log/JLinkRttReader.hpp"
 #include "uc_log/LogLevel.hpp"
 #include "uc_log/RttBlockInfo.hpp"
+#include "uc_log/ReorderQueueStats.hpp"
+#include "uc_log/RttReplayReader.hpp"
+#include "uc_log/SinkStats.hpp"
 #include "uc_log/TimeDelayedQueue.hpp"
+#include "uc_log/detail/CallSiteTable.hpp"
 #include "uc_log/detail/LogEntry.hpp"
 #include "uc_log/detail/LogFormat.hpp"
+#include "uc_log/detail/MetricRegistry.hpp"
+#include "uc_log/detail/SinkWorker.hpp"
 #include "uc_log/detail/TcpSender.hpp"
+#include "uc_log/detail/TimedEntry.hpp"
 #include "uc_log/metric_utils.hpp"
 
 #include <algorithm>
@@ -37,9 +44,22 @@
 #include <expected>
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <variant>
+#include <vector>
 
 namespace {
+using TimedLogEntry = uc_log::detail::TimedEntry<uc_log::detail::LogEntry>;
+
+std::optional<OverflowPolicy> parseOverflowPolicy(std::string_view policy) {
+    if(policy == "block") { return OverflowPolicy::Block; }
+    if(policy == "drop_oldest") { return OverflowPolicy::DropOldest; }
+    if(policy == "sample") { return OverflowPolicy::Sample; }
+    return std::nullopt;
+}
+
 std::expected<RttBlockInfo,
               std::string>
 parseMapFileForControlBlockInfo(std::filesystem::path const& mapFile) {
@@ -101,11 +121,13 @@ struct LogFilePrinter {
     bool                                                 logFileEnabled{true};
     std::mutex                                           mutex;
 
-    LogFilePrinter(uc_log::FTXUIGui::Gui& gui,
-                   std::string const&     logDir)
-      : errorMessagef{[&gui](auto const& m) { gui.errorMessage(m); }}
-      , statusChangef{[&gui](LogFileStatus    s,
-                             std::string_view p) { gui.setLogFileStatus(s, p); }} {
+    template<typename ErrorMessageF,
+             typename StatusChangeF>
+    LogFilePrinter(std::string const& logDir,
+                   ErrorMessageF&&    errorMessagef_,
+                   StatusChangeF&&    statusChangef_)
+      : errorMessagef{std::forward<ErrorMessageF>(errorMessagef_)}
+      , statusChangef{std::forward<StatusChangeF>(statusChangef_)} {
         openFileUnlocked(logDir);
     }
 
@@ -121,10 +143,17 @@ struct LogFilePrinter {
 
     void add(std::chrono::system_clock::time_point recv_time,
              uc_log::detail::LogEntry const&       entry) {
+        TimedLogEntry const timed{recv_time, entry};
+        addBatch(std::span{&timed, 1});
+    }
+
+    void addBatch(std::span<TimedLogEntry const> entries) {
         std::lock_guard<std::mutex> const lock{mutex};
         if(!logFileEnabled) { return; }
         if(logFile) {
-            uc_log::detail::logformat::writeEntry(logFile, recv_time, entry);
+            for(auto const& timed : entries) {
+                uc_log::detail::logformat::writeEntry(logFile, timed.recv_time, timed.entry);
+            }
         } else {
             if(!errorShown) {
                 errorMessagef(fmt::format("error writing logFile: {:?}", logFilePath));
@@ -155,30 +184,88 @@ private:
 struct TcpPrinter {
     TCPSender tcpSender;
 
-    TcpPrinter(uc_log::FTXUIGui::Gui& gui,
-               std::uint16_t          port)
+    template<typename ErrorMessageF,
+             typename StatusChangeF>
+    TcpPrinter(std::uint16_t   port,
+               ErrorMessageF&& errorMessagef,
+               StatusChangeF&& statusChangef)
       : tcpSender{port,
-                  [&gui](auto const& msg) { gui.errorMessage(msg); },
-                  [&gui](TcpPortStatus s,
-                         std::uint16_t p) { gui.setTcpPortStatus(s, p); }} {}
+                  std::forward<ErrorMessageF>(errorMessagef),
+                  std::forward<StatusChangeF>(statusChangef)} {}
 
     void restart(std::uint16_t newPort) { tcpSender.restart(newPort); }
 
-    void add(std::chrono::system_clock::time_point recv_time,
-             uc_log::detail::LogEntry const&       entry) {
-        auto const metrics = uc_log::extractMetrics(recv_time, entry);
-        for(auto const& metric : metrics) {
-            tcpSender.send(
-              fmt::format(R"("/*{{"name":{:?},"scope":{:?},"unit":{:?},"time":{},"value":{}}}*/{})",
-                          metric.first.name,
-                          metric.first.scope,
-                          metric.first.unit,
-                          std::chrono::duration<double>(metric.second.uc_time.time).count(),
-                          metric.second.value,
-                          '\n'));
+    void add(std::chrono::system_clock::time_point,
+             uc_log::detail::LogEntry const& entry) {
+        std::string out;
+        appendMetrics(out, entry);
+        if(!out.empty()) { tcpSender.send(out); }
+    }
+
+    // every metric line ends in a newline, so a whole batch goes out as one send
+    void addBatch(std::span<TimedLogEntry const> entries) {
+        std::string out;
+        for(auto const& timed : entries) { appendMetrics(out, timed.entry); }
+        if(!out.empty()) { tcpSender.send(out); }
+    }
+
+private:
+    static void appendMetrics(std::string&                    out,
+                              uc_log::detail::LogEntry const& entry) {
+        auto const& registry = uc_log::detail::MetricRegistry::instance();
+        auto const  time     = std::chrono::duration<double>(entry.ucTime.time).count();
+        for(auto const& sample : entry.metrics.view()) {
+            auto const& metric = registry[sample.metric];
+            // the value keeps the type it was logged with, integers are printed exactly
+            std::visit(
+              [&](auto value) {
+                  fmt::format_to(
+                    std::back_inserter(out),
+                    R"("/*{{"name":{:?},"scope":{:?},"unit":{:?},"time":{},"value":{}}}*/{})",
+                    metric.name,
+                    metric.scope,
+                    metric.unit,
+                    time,
+                    value,
+                    '\n');
+              },
+              sample.value);
         }
     }
 };
+
+template<typename Reader>
+void printHeadlessStats(Reader const&                 reader,
+                        ReorderQueueStats const&      queue,
+                        std::vector<SinkStats> const& sinks,
+                        std::uint64_t                 entries,
+                        std::chrono::duration<double> elapsed) {
+    fmt::print(stderr,
+               "[stats] {:.0f} entries/s, reorder window {:.1f}ms, {} pending, {} late\n",
+               static_cast<double>(entries) / elapsed.count(),
+               std::chrono::duration<double, std::milli>(queue.window).count(),
+               queue.pending,
+               queue.lateArrivals);
+    if constexpr(requires { reader.getPipelineStats(); }) {
+        auto const pipeline = reader.getPipelineStats();
+        fmt::print(stderr,
+                   "[stats] rtt {:.0f} B/s, {:.0f} msgs/s, {} ring stalls, {:.2f} overflows/s\n",
+                   pipeline.polledBytesPerSecond,
+                   pipeline.parsedMessagesPerSecond,
+                   pipeline.ringFullEvents,
+                   pipeline.overflowsPerSecond);
+    }
+    for(auto const& sink : sinks) {
+        fmt::print(stderr,
+                   "[stats] {}: {}/{} queued (peak {}), {} delivered, {} dropped\n",
+                   sink.name,
+                   sink.depth,
+                   sink.capacity,
+                   sink.maxDepth,
+                   sink.delivered,
+                   sink.dropped);
+    }
+}
 }   // namespace
 
 int main(int    argc,
@@ -192,8 +279,24 @@ int main(int    argc,
     std::string   logDir{};
     std::string   buildCommand{};
     std::uint16_t port{};
+    std::string   rawCaptureFile{};
+    std::string   replayFile{};
+    double        replaySpeed{};
+    std::size_t   parserThreads{};
+    std::size_t   sinkQueueSize{};
+    std::uint32_t statsInterval{};
+    std::size_t   maxLogEntries{};
+    std::size_t   maxLogMiB{};
+    unsigned      maxFps{};
+    std::size_t   metricSamples{};
+    std::size_t   metricBuckets{};
     bool          disableUi{false};
 
+    OverflowPolicy guiOverflow{};
+    OverflowPolicy tcpOverflow{};
+
+    JLinkRttReader::PollConfig pollConfig{};
+
     cxxopts::Options options("uc_log_printer");
     try {
         options.add_options()("metrics_port", "tcp for metrics", cxxopts::value<std::uint16_t>())(
@@ -213,81 +316,285 @@ int main(int    argc,
           cxxopts::value<std::string>())("host",
                                          "jlink host",
                                          cxxopts::value<std::string>()->default_value(""))(
+          "raw_capture",
+          "record the raw rtt stream to this .rttraw file",
+          cxxopts::value<std::string>()->default_value(""))(
+          "replay",
+          "replay a .rttraw file instead of connecting to a jlink",
+          cxxopts::value<std::string>()->default_value(""))(
+          "replay_speed",
+          "replay speed factor, 0 replays as fast as possible",
+          cxxopts::value<double>()->default_value("1"))(
+          "parser_threads",
+          "number of threads decoding rtt channels",
+          cxxopts::value<std::size_t>()->default_value("1"))(
+          "poll_min_us",
+          "shortest pause between rtt polls in microseconds",
+          cxxopts::value<std::uint32_t>()->default_value("100"))(
+          "poll_max_us",
+          "longest pause between rtt polls in microseconds",
+          cxxopts::value<std::uint32_t>()->default_value("20000"))(
+          "poll_latency_ms",
+          "upper bound on the delay before new rtt data is read",
+          cxxopts::value<std::uint32_t>()->default_value("10"))(
+          "rtt_buffer_size",
+          "assumed size of the target rtt up-buffers in bytes",
+          cxxopts::value<std::size_t>()->default_value("1024"))(
+          "sink_queue_size",
+          "entries each sink may fall behind before its overflow policy applies",
+          cxxopts::value<std::size_t>()->default_value("65536"))(
+          "gui_overflow",
+          "gui queue overflow policy: block, drop_oldest or sample",
+          cxxopts::value<std::string>()->default_value("sample"))(
+          "tcp_overflow",
+          "metrics tcp queue overflow policy: block, drop_oldest or sample",
+          cxxopts::value<std::string>()->default_value("drop_oldest"))(
+          "max_log_entries",
+          "log lines the gui keeps before dropping the oldest, 0 for no limit",
+          cxxopts::value<std::size_t>()->default_value("10000000"))(
+          "max_log_mb",
+          "memory in MiB the gui log history may use before dropping the oldest, 0 for no limit",
+          cxxopts::value<std::size_t>()->default_value("4096"))(
+          "max_fps",
+          "frames per second the gui draws at most, 0 for no limit",
+          cxxopts::value<unsigned>()->default_value("30"))(
+          "metric_samples",
+          "newest samples the gui keeps per metric at full resolution",
+          cxxopts::value<std::size_t>()->default_value("4096"))(
+          "metric_buckets",
+          "buckets the gui keeps per metric in each of its coarser min/max tiers",
+          cxxopts::value<std::size_t>()->default_value("1024"))(
+          "stats_interval",
+          "seconds between statistics printed to stderr with --disable_ui, 0 disables them",
+          cxxopts::value<std::uint32_t>()->default_value("10"))(
           "disable_ui",
           "disable ui and just log to file and tcp");
         auto const result   = options.parse(argc, argv);
+        replayFile          = result["replay"].as<std::string>();
+        replaySpeed         = result["replay_speed"].as<double>();
         port                = result["metrics_port"].as<std::uint16_t>();
-        speed               = result["speed"].as<std::uint32_t>();
-        device              = result["device"].as<std::string>();
         buildCommand        = result["build_command"].as<std::string>();
-        mapFile             = result["map_file"].as<std::string>();
-        hexFile             = result["hex_file"].as<std::string>();
         stringConstantsFile = result["string_constants_file"].as<std::string>();
         logDir              = result["log_dir"].as<std::string>();
         host                = result["host"].as<std::string>();
+        rawCaptureFile      = result["raw_capture"].as<std::string>();
+        parserThreads       = result["parser_threads"].as<std::size_t>();
+        sinkQueueSize       = result["sink_queue_size"].as<std::size_t>();
+        statsInterval       = result["stats_interval"].as<std::uint32_t>();
+        maxLogEntries       = result["max_log_entries"].as<std::size_t>();
+        maxLogMiB           = result["max_log_mb"].as<std::size_t>();
+        maxFps              = result["max_fps"].as<unsigned>();
+        metricSamples       = result["metric_samples"].as<std::size_t>();
+        metricBuckets       = result["metric_buckets"].as<std::size_t>();
         disableUi           = result.count("disable_ui") > 0;
+        if(replayFile.empty()) {
+            speed   = result["speed"].as<std::uint32_t>();
+            device  = result["device"].as<std::string>();
+            mapFile = result["map_file"].as<std::string>();
+            hexFile = result["hex_file"].as<std::string>();
+        }
+        pollConfig.minInterval
+          = std::chrono::microseconds{result["poll_min_us"].as<std::uint32_t>()};
+        pollConfig.maxInterval
+          = std::chrono::microseconds{result["poll_max_us"].as<std::uint32_t>()};
+        pollConfig.latencyTarget
+          = std::chrono::milliseconds{result["poll_latency_ms"].as<std::uint32_t>()};
+        pollConfig.upBufferSize = result["rtt_buffer_size"].as<std::size_t>();
+        for(auto [option, policy] :
+            {std::pair{"gui_overflow", &guiOverflow}, std::pair{"tcp_overflow", &tcpOverflow}})
+        {
+            auto const value  = result[option].as<std::string>();
+            auto const parsed = parseOverflowPolicy(value);
+            if(!parsed) { throw cxxopts::exceptions::incorrect_argument_type(value); }
+            *policy = *parsed;
+        }
     } catch(cxxopts::exceptions::exception const& e) {
         fmt::print(stderr, "Error: {}\n{}\n", e.what(), options.help());
         return 1;
     }
 
-    uc_log::FTXUIGui::Gui gui{};
-    LogFilePrinter        logFilePrinter{gui, logDir};
-    TcpPrinter            tcpPrinter{gui, port};
-    gui.setOnTcpPortChange([&tcpPrinter](std::uint16_t newPort) { tcpPrinter.restart(newPort); });
-    gui.setTcpClientCountGetter([&tcpPrinter]() { return tcpPrinter.tcpSender.getClientCount(); });
-    gui.setOnLogDirChange(
-      [&logFilePrinter](std::string const& newDir) { logFilePrinter.changeDir(newDir); });
-    gui.setOnLogFileEnable([&logFilePrinter](bool enabled) { logFilePrinter.setEnabled(enabled); });
-    gui.setOnTcpEnable([&tcpPrinter, port](bool enabled) {
-        if(enabled) {
-            auto const current = tcpPrinter.tcpSender.getPort();
-            tcpPrinter.restart(current != 0 ? current : port);
-        } else {
-            tcpPrinter.tcpSender.stop();
-        }
-    });
-
-    TimeDelayedQueue queue{
-      [](auto const& entry) { return entry.entry.ucTime; },
-      [&logFilePrinter, &tcpPrinter, &gui](std::chrono::system_clock::time_point recv_time,
-                                           uc_log::detail::LogEntry const&       entry) {
-          logFilePrinter.add(recv_time, entry);
-          tcpPrinter.add(recv_time, entry);
-          gui.add(recv_time, entry);
+    // headless runs never construct the gui, nothing but the bounded sink queues keeps entries
+    std::optional<uc_log::FTXUIGui::Gui> gui{};
+    if(!disableUi) {
+        gui.emplace();
+        gui->setLogStoreLimits(maxLogEntries, maxLogMiB << 20);
+        gui->setMaxFps(maxFps);
+        gui->setMetricSeriesLimits(metricSamples, metricBuckets);
+    }
+
+    auto const message = [&gui](void (uc_log::FTXUIGui::Gui::*guiMessage)(std::string_view),
+                                std::string_view prefix) {
+        return [&gui, guiMessage, prefix](std::string_view msg) {
+            if(gui) {
+                ((*gui).*guiMessage)(msg);
+            } else {
+                fmt::print(stderr, "{}{}\n", prefix, msg);
+            }
+        };
+    };
+    auto const fatalError       = message(&uc_log::FTXUIGui::Gui::fatalError, "fatal: ");
+    auto const statusMessage    = message(&uc_log::FTXUIGui::Gui::statusMessage, "");
+    auto const errorMessage     = message(&uc_log::FTXUIGui::Gui::errorMessage, "error: ");
+    auto const toolMessage      = message(&uc_log::FTXUIGui::Gui::toolStatusMessage, "");
+    auto const toolErrorMessage = message(&uc_log::FTXUIGui::Gui::toolErrorMessage, "error: ");
+
+    LogFilePrinter logFilePrinter{
+      logDir,
+      errorMessage,
+      [&gui](LogFileStatus    s,
+             std::string_view path) {
+          if(gui) {
+              gui->setLogFileStatus(s, path);
+          } else if(s == LogFileStatus::Active) {
+              fmt::print(stderr, "logging to {}\n", path);
+          }
+      }};
+    TcpPrinter tcpPrinter{port,
+                          errorMessage,
+                          [&gui](TcpPortStatus s,
+                                 std::uint16_t p) {
+                              if(gui) {
+                                  gui->setTcpPortStatus(s, p);
+                              } else if(s == TcpPortStatus::Active) {
+                                  fmt::print(stderr, "metrics on tcp port {}\n", p);
+                              }
+                          }};
+
+    // every sink drains its own queue, the log file is never allowed to lose entries
+    uc_log::detail::SinkWorker<TimedLogEntry> fileSink{
+      "Log File",
+      OverflowPolicy::Block,
+      sinkQueueSize,
+      [&logFilePrinter](std::span<TimedLogEntry const> entries) {
+          logFilePrinter.addBatch(entries);
       }};
+    uc_log::detail::SinkWorker<TimedLogEntry> tcpSink{
+      "Metrics TCP",
+      tcpOverflow,
+      sinkQueueSize,
+      [&tcpPrinter](std::span<TimedLogEntry const> entries) { tcpPrinter.addBatch(entries); }};
+    std::optional<uc_log::detail::SinkWorker<TimedLogEntry>> guiSink{};
+    if(gui) {
+        guiSink.emplace("GUI",
+                        guiOverflow,
+                        sinkQueueSize,
+                        [&gui](std::span<TimedLogEntry const> entries) { gui->addBatch(entries); });
+    }
+
+    TimeDelayedQueue queue{[](auto const& entry) { return entry.entry.ucTime; },
+                           [&fileSink, &tcpSink, &guiSink](std::span<TimedLogEntry const> entries) {
+                               fileSink.push(entries);
+                               tcpSink.push(entries);
+                               if(guiSink) { guiSink->push(entries); }
+                           }};
+
+    auto const sinkStats = [&fileSink, &tcpSink, &guiSink]() {
+        std::vector<SinkStats> stats{fileSink.stats(), tcpSink.stats()};
+        if(guiSink) { stats.push_back(guiSink->stats()); }
+        return stats;
+    };
+
+    if(gui) {
+        gui->setOnTcpPortChange(
+          [&tcpPrinter](std::uint16_t newPort) { tcpPrinter.restart(newPort); });
+        gui->setTcpClientCountGetter(
+          [&tcpPrinter]() { return tcpPrinter.tcpSender.getClientCount(); });
+        gui->setOnLogDirChange(
+          [&logFilePrinter](std::string const& newDir) { logFilePrinter.changeDir(newDir); });
+        gui->setOnLogFileEnable(
+          [&logFilePrinter](bool enabled) { logFilePrinter.setEnabled(enabled); });
+        gui->setOnTcpEnable([&tcpPrinter, port](bool enabled) {
+            if(enabled) {
+                auto const current = tcpPrinter.tcpSender.getPort();
+                tcpPrinter.restart(current != 0 ? current : port);
+            } else {
+                tcpPrinter.tcpSender.stop();
+            }
+        });
+        gui->setSinkStatsGetter(sinkStats);
+        gui->setQueueStatsGetter([&queue]() { return queue.getStats(); });
+    }
+
+    // readers only reload the catalog while no channel is being parsed, so entryPrint never
+    // races with the table being rebuilt
+    uc_log::detail::CallSiteTable callSites{};
+
+    auto const catalogMap = [&stringConstantsFile, &fatalError, &callSites]() {
+        auto const result = remote_fmt::parseStringConstantsFromJsonFile(stringConstantsFile);
+        if(!result.has_value()) { fatalError(result.error()); }
+        auto catalog = result.value_or({});
+        callSites    = uc_log::detail::CallSiteTable{catalog};
+        return catalog;
+    };
+    auto const entryPrint = [&queue, &callSites](std::size_t channel, std::string_view msg) {
+        queue.append(channel, uc_log::detail::makeLogEntry(channel, msg, callSites));
+    };
+
+    auto const run = [&](auto& reader) {
+        if(gui) { return gui->run(reader, buildCommand, host); }
+
+        static std::atomic<bool> shutdown_requested(false);
+        std::signal(SIGINT, [](int signal) {
+            if(signal == SIGINT) { shutdown_requested = true; }
+        });
+
+        using Clock = std::chrono::steady_clock;
+        auto          lastStats     = Clock::now();
+        std::uint64_t lastDelivered = fileSink.stats().delivered;
+        while(!shutdown_requested) {
+            if(statsInterval != 0
+               && Clock::now() - lastStats >= std::chrono::seconds{statsInterval})
+            {
+                auto const now   = Clock::now();
+                auto const stats = sinkStats();
+                printHeadlessStats(reader,
+                                   queue.getStats(),
+                                   stats,
+                                   stats.front().delivered - lastDelivered,
+                                   now - lastStats);
+                lastStats     = now;
+                lastDelivered = stats.front().delivered;
+            }
+            if constexpr(requires { reader.finished(); }) {
+                if(reader.finished()) { break; }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        // the tail of a replay and whatever is held on Ctrl-C still has to reach the sinks
+        queue.flush();
+        return 0;
+    };
+
+    if(!replayFile.empty()) {
+        RttReplayReader replayReader{replayFile,
+                                     replaySpeed,
+                                     catalogMap,
+                                     entryPrint,
+                                     statusMessage,
+                                     errorMessage,
+                                     toolMessage,
+                                     toolErrorMessage};
+        return run(replayReader);
+    }
 
     JLinkRttReader rttReader{host,
                              device,
                              speed,
-                             [&mapFile, &gui]() {
+                             rawCaptureFile,
+                             [&mapFile, &fatalError]() {
                                  auto const result = parseMapFileForControlBlockInfo(mapFile);
-                                 if(!result.has_value()) { gui.fatalError(result.error()); }
+                                 if(!result.has_value()) { fatalError(result.error()); }
                                  return result.value_or(RttBlockInfo{});
                              },
                              [&hexFile]() { return hexFile; },
-                             [&stringConstantsFile, &gui]() {
-                                 auto const result = remote_fmt::parseStringConstantsFromJsonFile(
-                                   stringConstantsFile);
-                                 if(!result.has_value()) { gui.fatalError(result.error()); }
-                                 return result.value_or({});
-                             },
-                             [&queue](std::size_t channel, std::string_view msg) {
-                                 queue.append(uc_log::detail::LogEntry{channel, msg});
-                             },
-                             [&gui](std::string_view msg) { gui.statusMessage(msg); },
-                             [&gui](std::string_view msg) { gui.errorMessage(msg); },
-                             [&gui](std::string_view msg) { gui.toolStatusMessage(msg); },
-                             [&gui](std::string_view msg) { gui.toolErrorMessage(msg); }};
+                             catalogMap,
+                             entryPrint,
+                             statusMessage,
+                             errorMessage,
+                             toolMessage,
+                             toolErrorMessage};
+    rttReader.setParserThreadCount(parserThreads);
+    rttReader.setPollConfig(pollConfig);
 
-    if(!disableUi) {
-        return gui.run(rttReader, buildCommand, host);
-    } else {
-        static std::atomic<bool> shutdown_requested(false);
-        std::signal(SIGINT, [](int signal) {
-            if(signal == SIGINT) { shutdown_requested = true; }
-        });
-        while(!shutdown_requested) { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }
-        return 0;
-    }
+    return run(rttReader);
 }
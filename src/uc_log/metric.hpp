@@ -14,6 +14,8 @@ template<typename ValueType,
          sc::StringConstant Unit_,
          sc::StringConstant Scope_>
 struct Metric : metric_tag {
+    using value_type = ValueType;
+
     ValueType const& value;
 
     Metric(ValueType const& value_) : value{value_} {}
@@ -33,6 +35,23 @@ constexpr auto metric(auto const& value) {
 
 namespace detail {
 
+    // `#t` behind the unit tells the host the type to parse the value in, so integers and floats
+    // keep their precision, other types are parsed as double
+    template<typename T>
+    consteval char metricTypeCode() {
+        if constexpr(std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+            return '\0';
+        } else if constexpr(std::is_integral_v<T>) {
+            return std::is_signed_v<T> ? 'i' : 'u';
+        } else if constexpr(std::is_same_v<T, float>) {
+            return 'f';
+        } else if constexpr(std::is_floating_point_v<T>) {
+            return 'd';
+        } else {
+            return '\0';
+        }
+    }
+
     template<std::size_t ArgIndex,
              typename Arg>
     consteval auto getMetricPrefix() {
@@ -46,8 +65,9 @@ namespace detail {
               = std::string_view{MetricType::Unit.storage.data(), MetricType::Unit.storage.size()};
 
             constexpr auto        prefix = std::string_view{"@METRIC("};
+            constexpr char        type   = metricTypeCode<typename MetricType::value_type>();
             constexpr std::size_t total_size
-              = prefix.size() + scope.size() + name.size() + unit.size() + 5;
+              = prefix.size() + scope.size() + name.size() + unit.size() + 5 + (type ? 2 : 0);
 
             std::array<char, total_size> result{};
             std::size_t                  pos = 0;
@@ -64,6 +84,11 @@ namespace detail {
             for(char c : unit) { result[pos++] = c; }
             result[pos++] = ']';
 
+            if constexpr(type != '\0') {
+                result[pos++] = '#';
+                result[pos++] = type;
+            }
+
             result[pos++] = '=';
 
             return std::make_pair(result, pos);
@@ -82,9 +107,13 @@ namespace detail {
               = std::array{std::is_base_of_v<metric_tag, std::remove_cvref_t<Args>>...};
             constexpr auto metric_prefixes = std::make_tuple(getMetricPrefix<Is, Args>()...);
 
-            std::array<char, sizeof...(chars) * 4> output{};
-            std::size_t                            out_pos   = 0;
-            std::size_t                            arg_index = 0;
+            // every metric adds its prefix and the closing parenthesis
+            constexpr std::size_t metrics_size
+              = (std::size_t{} + ... + (std::get<Is>(metric_prefixes).second + 1));
+
+            std::array<char, sizeof...(chars) + metrics_size> output{};
+            std::size_t                                       out_pos   = 0;
+            std::size_t                                       arg_index = 0;
 
             for(std::size_t i = 0; i < input.size(); ++i) {
                 if(input[i] == '{') {
@@ -1,98 +1,178 @@
 #pragma once
 
-#include "uc_log/LogLevel.hpp"
+#include "uc_log/MetricInfo.hpp"
 #include "uc_log/detail/LogEntry.hpp"
-
-#include <chrono>
-#include <stdexcept>
+#include "uc_log/detail/MetricRegistry.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
-#include <utility>
+#include <system_error>
 #include <vector>
 
 namespace uc_log {
-struct MetricInfo {
-    std::string scope;
-    std::string name;
-    std::string unit;
-
-    auto operator<=>(MetricInfo const&) const = default;
-};
-
-struct MetricEntry {
-    std::chrono::system_clock::time_point recv_time;
-    uc_log::LogLevel                      level;
-    uc_log::detail::LogEntry::UcTime      uc_time;
-    double                                value;
-};
-
-inline std::vector<std::pair<MetricInfo,
-                             MetricEntry>>
-extractMetrics(std::chrono::system_clock::time_point recv_time,
-               uc_log::detail::LogEntry const&       logEntry) {
-    std::vector<std::pair<MetricInfo, MetricEntry>> metrics;
-
-    std::string_view const msg{logEntry.logMsg};
-    std::size_t            pos = 0;
-
-    while((pos = msg.find("@METRIC(", pos)) != std::string_view::npos) {
-        pos += 8;
+namespace detail {
+    /// Type a metric was logged with, see the `#t` tag metric.hpp puts behind the unit.
+    enum class MetricValueType : std::uint8_t { Unknown, Signed, Unsigned, Float, Double };
+
+    /// `scope::name[unit]#t`, the text between `@METRIC(` and `=`.
+    struct MetricMarker {
+        std::string_view scope;   // empty for the call site
+        std::string_view name;
+        std::string_view unit;
+        MetricValueType  type{};
+    };
+
+    inline std::optional<MetricMarker> parseMetricMarker(std::string_view marker) {
+        std::size_t const scope_end = marker.find("::");
+        if(scope_end == std::string_view::npos) { return std::nullopt; }
+
+        MetricMarker result{};
+        result.scope          = marker.substr(0, scope_end);
+        std::string_view name = marker.substr(scope_end + 2);
+
+        if(name.size() >= 2 && name[name.size() - 2] == '#') {
+            constexpr std::string_view Codes{"iufd"};
+            if(auto const code = Codes.find(name.back()); code != std::string_view::npos) {
+                result.type = static_cast<MetricValueType>(code + 1);
+                name.remove_suffix(2);
+            }
+        }
 
-        std::size_t const end_pos = msg.find(')', pos);
-        if(end_pos == std::string_view::npos) { break; }
+        std::size_t const bracket_start = name.find('[');
+        if(bracket_start != std::string_view::npos) {
+            std::size_t const bracket_end = name.find(']', bracket_start);
+            if(bracket_end != std::string_view::npos) {
+                result.unit = name.substr(bracket_start + 1, bracket_end - bracket_start - 1);
+                name        = name.substr(0, bracket_start);
+            }
+        }
+        result.name = name;
+        return result;
+    }
 
-        std::string_view const metric_content = msg.substr(pos, end_pos - pos);
+    template<typename T>
+    std::optional<MetricValue> parseAs(std::string_view text) {
+        T value{};
+        auto const [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if(ec != std::errc{}) { return std::nullopt; }
+        return MetricValue{value};
+    }
 
-        std::size_t const scope_end = metric_content.find("::");
-        if(scope_end == std::string_view::npos) {
-            pos = end_pos + 1;
-            continue;
+    /// Parses a metric value in its logged type. Values of unknown type become integers if they
+    /// are written as one and fit, doubles otherwise. Like std::stod, leading blanks and a plus
+    /// sign are accepted and trailing text is ignored.
+    inline std::optional<MetricValue> parseMetricValue(std::string_view text,
+                                                       MetricValueType  type) {
+        text.remove_prefix(std::min(text.find_first_not_of(" \t"), text.size()));
+        if(text.starts_with('+')) { text.remove_prefix(1); }
+        switch(type) {
+        case MetricValueType::Signed:   return parseAs<std::int64_t>(text);
+        case MetricValueType::Unsigned: return parseAs<std::uint64_t>(text);
+        case MetricValueType::Float:    return parseAs<float>(text);
+        case MetricValueType::Double:   return parseAs<double>(text);
+        case MetricValueType::Unknown:  break;
         }
 
-        std::string scope{metric_content.substr(0, scope_end)};
-        if(scope.empty()) { scope = logEntry.fileName + ":" + std::to_string(logEntry.line); }
-
-        std::string_view const remainder = metric_content.substr(scope_end + 2);
+        double value{};
+        auto const [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if(ec != std::errc{}) { return std::nullopt; }
+        std::string_view const number{text.data(), static_cast<std::size_t>(ptr - text.data())};
+        if(std::ranges::all_of(number, [](char c) { return c == '-' || (c >= '0' && c <= '9'); })) {
+            if(auto integer = parseAs<std::int64_t>(number)) { return integer; }
+            if(auto integer = parseAs<std::uint64_t>(number)) { return integer; }
+        }
+        return MetricValue{value};
+    }
 
-        std::size_t const equals_pos = remainder.find('=');
-        if(equals_pos == std::string_view::npos) {
-            pos = end_pos + 1;
-            continue;
+    /// A metric of a catalog format string, resolved once when the catalog is loaded.
+    struct MetricSlot {
+        std::string     marker;   // `@METRIC(scope::name[unit]#t=` as it appears in the message
+        MetricId        id;
+        MetricValueType type;
+
+        bool operator==(MetricSlot const&) const = default;
+    };
+
+    /// Metric values of a message built from a format string with the metrics `slots`. Only
+    /// looks for the known markers in order, nothing is interned or allocated per metric.
+    /// Returns nullopt if a marker is missing, the message then needs the text search.
+    inline std::optional<MetricSamples> extractMetrics(std::string_view            payload,
+                                                       std::span<MetricSlot const> slots) {
+        if(slots.empty()) { return MetricSamples{}; }
+        thread_local std::vector<MetricSample> samples;
+        samples.clear();
+        std::size_t pos{};
+        for(auto const& slot : slots) {
+            auto const found = payload.find(slot.marker, pos);
+            if(found == std::string_view::npos) { return std::nullopt; }
+            pos = found + slot.marker.size();
+            if(auto const value = parseMetricValue(payload.substr(pos), slot.type)) {
+                samples.push_back(MetricSample{slot.id, *value});
+            }
         }
+        return MetricSamples{samples};
+    }
+}   // namespace detail
+
+/// Finds the `@METRIC(scope::name[unit]=value)` markers of the message and stores their values
+/// in `logEntry.metrics`.
+///
+/// Runs once per entry on the parser threads, sinks only read the attached samples. An empty
+/// scope stands for the call site, `file:line`. Messages of a catalog call site take the faster
+/// path through its MetricSlots instead, see makeLogEntry.
+inline void extractMetrics(uc_log::detail::LogEntry& logEntry) {
+    using uc_log::detail::MetricRegistry;
+    using uc_log::detail::MetricSample;
+
+    std::string_view const msg{logEntry.logMsg()};
+    std::size_t            pos = msg.find("@METRIC(");
+    if(pos == std::string_view::npos) {
+        logEntry.metrics = {};
+        return;
+    }
 
-        std::string_view const name_and_unit = remainder.substr(0, equals_pos);
-        std::string_view const value_str     = remainder.substr(equals_pos + 1);
+    thread_local std::vector<MetricSample> samples;
+    samples.clear();
+    auto& registry = MetricRegistry::instance();
 
-        std::string name;
-        std::string unit;
+    for(; pos != std::string_view::npos; pos = msg.find("@METRIC(", pos)) {
+        pos += 8;
 
-        std::size_t const bracket_start = name_and_unit.find('[');
-        if(bracket_start != std::string_view::npos) {
-            std::size_t const bracket_end = name_and_unit.find(']', bracket_start);
-            if(bracket_end != std::string_view::npos) {
-                name = std::string{name_and_unit.substr(0, bracket_start)};
-                unit = std::string{
-                  name_and_unit.substr(bracket_start + 1, bracket_end - bracket_start - 1)};
-            } else {
-                name = std::string{name_and_unit};
-            }
-        } else {
-            name = std::string{name_and_unit};
-        }
+        std::size_t const end_pos = msg.find(')', pos);
+        if(end_pos == std::string_view::npos) { break; }
 
-        try {
-            double const value = std::stod(std::string{value_str});
+        std::string_view const metric_content = msg.substr(pos, end_pos - pos);
+        pos                                   = end_pos + 1;
 
-            metrics.emplace_back(MetricInfo{.scope = scope, .name = name, .unit = unit},
-                                 MetricEntry{.recv_time = recv_time,
-                                             .level     = logEntry.logLevel,
-                                             .uc_time   = logEntry.ucTime,
-                                             .value     = value});
-        } catch(std::invalid_argument const&) {}
+        std::size_t const scope_end = metric_content.find("::");
+        if(scope_end == std::string_view::npos) { continue; }
+        std::size_t const equals_pos = metric_content.find('=', scope_end + 2);
+        if(equals_pos == std::string_view::npos) { continue; }
+
+        auto const marker = detail::parseMetricMarker(metric_content.substr(0, equals_pos));
+        auto const value
+          = detail::parseMetricValue(metric_content.substr(equals_pos + 1), marker->type);
+        if(!value) { continue; }
+
+        std::string_view   scope = marker->scope;
+        fmt::memory_buffer defaultScope;
+        if(scope.empty()) {
+            fmt::format_to(
+              std::back_inserter(defaultScope), "{}:{}", logEntry.fileName(), logEntry.line());
+            scope = std::string_view{defaultScope.data(), defaultScope.size()};
+        }
 
-        pos = end_pos + 1;
+        auto const id = registry.intern(scope, marker->name, marker->unit);
+        if(id != MetricRegistry::Invalid) { samples.push_back(MetricSample{id, *value}); }
     }
 
-    return metrics;
+    logEntry.metrics = uc_log::detail::MetricSamples{samples};
 }
 }   // namespace uc_log
@@ -29,7 +29,7 @@ def extract_metrics(filepath: str) -> List[MetricInfo]:
         data = json.load(f)
 
     metrics = []
-    metric_regex = r'@METRIC\(([^:]*?)::([^[\]]+?)(?:\[([^\]]*)\])?=([^)]+)\)'
+    metric_regex = r'@METRIC\(([^:]*?)::([^[\]#]+?)(?:\[([^\]]*)\])?(?:#[iufd])?=([^)]+)\)'
 
     for entry in data.get("StringConstants", []):
         if len(entry) >= 2: